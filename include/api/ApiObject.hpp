@@ -528,6 +528,9 @@ enum error_codes : s32 {
 	error_code_flag_ux = 0x00400000,
 	error_code_flag_var = 0x00800000,
 
+	error_code_calc_lz_bad_format /*! The data isn't an Lz stream (1) */ = -(error_code_flag_calc|1),
+	error_code_calc_lz_corrupt_block /*! An Lz block can't be decompressed (2) */ = -(error_code_flag_calc|2),
+
 	error_code_crypto_size_mismatch = -(error_code_flag_crypto|1),
 	error_code_crypto_bad_block_size = -(error_code_flag_crypto|2),
 	error_code_crypto_operation_failed = -(error_code_flag_crypto|3),
@@ -535,6 +538,9 @@ enum error_codes : s32 {
 	error_code_crypto_unsupported_operation = -(error_code_flag_crypto|5),
 	error_code_crypto_bad_iv_size = -(error_code_flag_crypto|6),
 
+	error_code_fmt_csv_unterminated_quote /*! A quoted CSV field is missing the closing quote (1) */ = -(error_code_flag_fmt|1),
+	error_code_fmt_csv_column_not_found /*! The CSV header doesn't have the column (2) */ = -(error_code_flag_fmt|2),
+
 	error_code_fs_failed_to_open = -(error_code_flag_fs|1),
 	error_code_fs_failed_to_read = -(error_code_flag_fs|2),
 	error_code_fs_failed_to_write = -(error_code_flag_fs|3),
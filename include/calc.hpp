@@ -10,8 +10,10 @@ namespace calc {}
 
 #include "calc/Base64.hpp"
 #include "calc/Checksum.hpp"
+#include "calc/Crc.hpp"
 #include "calc/Filter.hpp"
 #include "calc/Lookup.hpp"
+#include "calc/Lz.hpp"
 #include "calc/Pid.hpp"
 #include "calc/Rle.hpp"
 
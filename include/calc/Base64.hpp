@@ -5,8 +5,15 @@
 
 #include "../api/CalcObject.hpp"
 #include "../var/Reference.hpp"
+#include "../var/StringView.hpp"
 #include "../fs/File.hpp"
 
+#if defined __link
+#define SAPI_BASE64_DEFAULT_PAGE_SIZE (48*1024)
+#else
+#define SAPI_BASE64_DEFAULT_PAGE_SIZE 768
+#endif
+
 namespace calc {
 
 class Base64Options {
@@ -21,6 +28,10 @@ class Base64Options {
  * transmitting data over certain serial links that do not support binary
  * transfers.
  *
+ * Link builds on x86-64 encode and decode 24 or 48 bytes at a time
+ * using AVX2 (or SSSE3) shuffles when the processor supports them.
+ * Other builds use table lookups.
+ *
  * The following example can be used to encode and decode
  * using Base64.
  *
@@ -65,6 +76,7 @@ public:
 	using DestinationString = var::String::Destination;
 
 	using Size = var::Reference::Size;
+	using PageSize = fs::File::PageSize;
 	using SourceFile = fs::File::Source;
 	using DestinationFile = fs::File::Destination;
 
@@ -85,22 +97,17 @@ public:
 			const var::Reference & input
 			);
 
-	static int encode(
-			SourceFile source,
-			DestinationFile destination,
-			Size size
-			);
-
-
-	/*! \details Reads binary data from *input* and writes a Base64
-	 * encoded string to *output*.
+	/*! \details Reads binary data from *source* and writes a Base64
+	 * encoded string to *destination*.
 	 *
-	 * @return Number of encoded bytes written to *output*
+	 * @return Number of bytes read from *source* or less than zero for an error
 	 *
-	 * The method reads *size* bytes (or to EOF if *size* is zero) from *input*
-	 * start at the current location. The output string is written to *output*
+	 * The method reads *size* bytes (or to EOF if *size* is zero) from *source*
+	 * starting at the current location. The output string is written to *destination*
 	 * at the current location.
 	 *
+	 * The data is processed *page_size* bytes at a time (rounded
+	 * down to a multiple of 3).
 	 *
 	 * ```
 	 * //md2code:main
@@ -123,7 +130,21 @@ public:
 	 *   );
 	 * ```
 	 *
+	 */
+	static int encode(
+			SourceFile source,
+			DestinationFile destination,
+			Size size = Size(0),
+			PageSize page_size = PageSize(SAPI_BASE64_DEFAULT_PAGE_SIZE)
+			);
+
+	/*! \details Encodes *size* bytes (or all if *size* is zero) of
+	 * *source* and assigns the result to *destination*.
+	 *
+	 * @return Number of bytes in the encoded string
 	 *
+	 * *destination* is resized once so it can be reused to
+	 * encode many buffers without allocating memory.
 	 *
 	 */
 	static int encode(
@@ -151,6 +172,19 @@ public:
 			const var::String & input
 			);
 
+	/*! \details Decodes *input* and assigns the result to *destination*.
+	 *
+	 * @return Number of decoded bytes
+	 *
+	 * *destination* is resized once so it can be reused to
+	 * decode many strings without allocating memory.
+	 *
+	 */
+	static int decode(
+			const var::StringView & input,
+			var::Data & destination
+			);
+
 	/*! \details Reads base64 encoded data from *input* and writes raw,
 	 * decoded data to *output*.
 	 *
@@ -160,23 +194,32 @@ public:
 	 * start at the current location. The output string is written to *output*
 	 * at the current location.
 	 *
+	 * The data is processed *page_size* bytes at a time (rounded
+	 * down to a multiple of 4).
 	 *
 	 */
 	static int decode(
 			SourceFile input,
 			DestinationFile output,
-			Size size = Size(0)
+			Size size = Size(0),
+			PageSize page_size = PageSize(SAPI_BASE64_DEFAULT_PAGE_SIZE)
 			);
 
+	/*! \details Returns the number of characters needed to encode *nbyte* bytes. */
+	static u32 calc_encoded_size(u32 nbyte){
+		return ((nbyte + 2) / 3) * 4;
+	}
 
-private:
-	static int encode(char * dest, const void * src, int nbyte);
-	static int decode(void * dest, const char * src, int nbyte);
-	static int calc_decoded_size(int nbyte);
-	static int calc_encoded_size(int nbyte);
-	static char encode_six(u8 six_bit_value);
-	static char decode_eigth(u8 eight_bit_value);
+	/*! \details Returns the maximum number of bytes that *nbyte*
+	 * encoded characters decode to (padding is not subtracted).
+	 */
+	static u32 calc_decoded_size(u32 nbyte){
+		return (nbyte*3+3)/4;
+	}
 
+private:
+	static u32 encode(char * dest, const void * src, u32 nbyte);
+	static u32 decode(void * dest, const char * src, u32 nbyte);
 
 };
 
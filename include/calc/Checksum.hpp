@@ -4,6 +4,7 @@
 
 #include "../var/Data.hpp"
 #include "../api/CalcObject.hpp"
+#include "Crc.hpp"
 
 
 namespace  calc {
@@ -164,6 +165,26 @@ public:
 	static u32 calc_zero_sum8(const var::Data & data);
 	static bool verify_zero_sum8(const var::Data & data);
 
+	/*! \details Calculates the CRC-8/SMBUS of \a data (see Crc). */
+	static u8 crc8(const var::Reference & data){
+		return Crc::calculate(Crc::type_crc8, data);
+	}
+
+	/*! \details Calculates the CRC-16/CCITT-FALSE of \a data (see Crc). */
+	static u16 crc16(const var::Reference & data){
+		return Crc::calculate(Crc::type_crc16, data);
+	}
+
+	/*! \details Calculates the CRC-32 of \a data (see Crc). */
+	static u32 crc32(const var::Reference & data){
+		return Crc::calculate(Crc::type_crc32, data);
+	}
+
+	/*! \details Calculates the CRC-32C of \a data (see Crc). */
+	static u32 crc32c(const var::Reference & data){
+		return Crc::calculate(Crc::type_crc32c, data);
+	}
+
 
 };
 
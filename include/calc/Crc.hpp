@@ -0,0 +1,123 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_CALC_CRC_HPP_
+#define SAPI_CALC_CRC_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "../var/Reference.hpp"
+#include "../fs/File.hpp"
+
+namespace calc {
+
+/*! \brief CRC Class
+ * \details The Crc class calculates cyclic redundancy checks.
+ *
+ * | Type | Parameters | Check ("123456789") |
+ * |------|------------|---------------------|
+ * | type_crc8 | CRC-8/SMBUS: poly 0x07, init 0x00 | 0xF4 |
+ * | type_crc16 | CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF | 0x29B1 |
+ * | type_crc32 | CRC-32 (zip, png, ethernet): poly 0x04C11DB7 reflected | 0xCBF43926 |
+ * | type_crc32c | CRC-32C (iSCSI, ext4): poly 0x1EDC6F41 reflected | 0xE3069283 |
+ *
+ * The data is processed 8 bytes at a time using tables (slicing-by-8).
+ * Link builds on x86-64 use the SSE4.2 crc32 instruction for
+ * type_crc32c and carry-less multiplication (PCLMULQDQ) for
+ * type_crc32 when the processor supports them. Other builds use a
+ * single 256-entry table for each type to save RAM.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/calc.hpp>
+ * #include <sapi/fs.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * File image;
+ * image.open("/home/image.bin", OpenFlags::read_only());
+ * Crc crc(Crc::type_crc32);
+ * crc.update(image);
+ * printf("crc is 0x%08lX\n", crc.value());
+ * ```
+ *
+ */
+class Crc : public api::WorkObject {
+public:
+
+	enum type {
+		type_crc8 /*! CRC-8/SMBUS */,
+		type_crc16 /*! CRC-16/CCITT-FALSE */,
+		type_crc32 /*! CRC-32 */,
+		type_crc32c /*! CRC-32C (Castagnoli) */,
+		type_total
+	};
+
+	explicit Crc(enum type type = type_crc32);
+
+	/*! \details Starts a new calculation. */
+	Crc & reset();
+
+	/*! \details Adds \a size bytes of \a data to the calculation. */
+	Crc & update(const void * data, u32 size);
+
+	/*! \details Adds the contents of \a data to the calculation. */
+	Crc & update(const var::Reference & data){
+		return update(data.to_const_void(), data.size());
+	}
+
+	/*! \details Reads \a file from the current location to the end
+	 * and adds the data to the calculation.
+	 *
+	 * @param file The file to read
+	 * @param page_size The number of bytes to read at a time
+	 * @return The number of bytes read or less than zero if the file could not be read
+	 *
+	 */
+	int update(
+			const fs::File & file,
+			fs::File::PageSize page_size = fs::File::PageSize(1024)
+			);
+
+	/*! \details Returns the CRC of the data added since the last reset(). */
+	u32 value() const;
+
+	enum type type() const { return m_type; }
+
+	/*! \details Calculates the CRC of \a data. */
+	static u32 calculate(enum type type, const var::Reference & data){
+		return Crc(type).update(data).value();
+	}
+
+	/*! \details Returns the CRC of two blocks of data joined together.
+	 *
+	 * @param type The type of CRC
+	 * @param first_value The CRC of the first block
+	 * @param second_value The CRC of the second block
+	 * @param second_size The number of bytes in the second block
+	 *
+	 * This allows blocks to be processed in parallel (or out of order)
+	 * and then combined.
+	 *
+	 */
+	static u32 combine(
+			enum type type,
+			u32 first_value,
+			u32 second_value,
+			u32 second_size
+			);
+
+	/*! \details Returns the number of bits in the CRC. */
+	static u32 width(enum type type);
+
+	/*! \details Returns true if \a type uses processor instructions on this machine. */
+	static bool is_hardware_accelerated(enum type type);
+
+private:
+	/*! \cond */
+	enum type m_type;
+	u32 m_register;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_CALC_CRC_HPP_
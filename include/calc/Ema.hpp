@@ -68,12 +68,25 @@ public:
 	 * @return The updated average (same as average())
 	 */
 	intmedium calculate(intmedium in){
-		intlarge tmp0;
-		tmp0 = (intlarge)in * (m_alpha) + (intlarge)m_average * (small_max() - m_alpha);
-		m_average = (intmedium)(((intlarge)tmp0 + (intlarge)small_max()) >> (sizeof(intsmall)*8));
+		m_average = next(in, m_average, m_alpha);
 		return m_average;
 	}
 
+	/*! \details Filters \a count values from \a input and
+	 * writes the results to \a output (which can be the same as \a input).
+	 *
+	 * The results are the same as calling calculate() for each value.
+	 *
+	 */
+	void calculate(const intmedium * input, intmedium * output, u32 count){
+		intmedium average = m_average;
+		const intsmall alpha = m_alpha;
+		for(u32 i=0; i < count; i++){
+			output[i] = average = next(input[i], average, alpha);
+		}
+		m_average = average;
+	}
+
 	intmedium calc(intmedium in){ return calculate(in); }
 
 	/*! \details Accesses the current average (no calculations are made here).
@@ -94,6 +107,12 @@ public:
 private:
 	intmedium m_average;
 	intsmall m_alpha;
+
+	static intmedium next(intmedium in, intmedium average, intsmall alpha){
+		intlarge tmp0;
+		tmp0 = (intlarge)in * (alpha) + (intlarge)average * (small_max() - alpha);
+		return (intmedium)(((intlarge)tmp0 + (intlarge)small_max()) >> (sizeof(intsmall)*8));
+	}
 };
 
 /*! \brief Exponential Moving Average class (s32) */
@@ -141,6 +160,18 @@ public:
 		return m_average;
 	}
 
+	/*! \details Filters \a count values from \a input and
+	 * writes the results to \a output (which can be the same as \a input).
+	 */
+	void calculate(const float * input, float * output, u32 count){
+		float average = m_average;
+		const float alpha = m_alpha;
+		for(u32 i=0; i < count; i++){
+			output[i] = average = input[i] * (alpha) + average * (1.0f - alpha);
+		}
+		m_average = average;
+	}
+
 	float calc(float in){ return calculate(in); }
 
 	/*! \details Accesses the present value of the filter. */
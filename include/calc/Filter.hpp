@@ -5,6 +5,8 @@
 
 #include <cstdio>
 #include "../api/CalcObject.hpp"
+#include "../var/Ring.hpp"
+#include "../var/Vector.hpp"
 
 namespace calc {
 
@@ -28,6 +30,23 @@ public:
 	 */
 	virtual T calculate(T a) = 0;
 
+	/*! \details Pops up to \a count values from \a input (oldest first),
+	 * filters them and writes the results to \a output.
+	 *
+	 * @return The number of values filtered
+	 *
+	 * This doesn't make a virtual call for each value.
+	 *
+	 */
+	u32 calculate(var::Ring<T> & input, T * output, u32 count){
+		u32 result = 0;
+		while( (result < count) && (input.is_empty() == false) ){
+			output[result++] = static_cast<C*>(this)->C::calculate(input.back());
+			input.pop();
+		}
+		return result;
+	}
+
 	/*! \details Returns a copy of the present value. */
 	T present_value() const { return m_present_value; }
 
@@ -120,12 +139,27 @@ public:
 	 * @return The updated average (same as average())
 	 */
 	intmedium calculate(intmedium in) override {
-		intlarge tmp0;
-		tmp0 = (intlarge)in * (m_alpha) + (intlarge)m_average * (small_max() - m_alpha);
-		m_average = (intmedium)(((intlarge)tmp0 + (intlarge)small_max()) >> (sizeof(intsmall)*8));
+		m_average = next(in, m_average, m_alpha);
 		return m_average;
 	}
 
+	/*! \details Filters \a count values from \a input and
+	 * writes the results to \a output (which can be the same as \a input).
+	 *
+	 * The results are the same as calling calculate() for each value.
+	 *
+	 */
+	void calculate(const intmedium * input, intmedium * output, u32 count){
+		intmedium average = m_average;
+		const intsmall alpha = m_alpha;
+		for(u32 i=0; i < count; i++){
+			output[i] = average = next(input[i], average, alpha);
+		}
+		m_average = average;
+	}
+
+	using SimpleFilter<intmedium, LowPassFilter<intsmall, intmedium, intlarge>>::calculate;
+
 	/*! \details Accesses the current average (no calculations are made here).
 	 *
 	 * @return The current average value
@@ -144,6 +178,12 @@ public:
 private:
 	intmedium m_average;
 	intsmall m_alpha;
+
+	static intmedium next(intmedium in, intmedium average, intsmall alpha){
+		intlarge tmp0;
+		tmp0 = (intlarge)in * (alpha) + (intlarge)average * (small_max() - alpha);
+		return (intmedium)(((intlarge)tmp0 + (intlarge)small_max()) >> (sizeof(intsmall)*8));
+	}
 };
 
 /*! \brief LowPassFilter class (s32) */
@@ -207,6 +247,16 @@ public:
 	void reset(float start);
 	float calculate(float in) override;
 
+	/*! \details Filters \a count values from \a input and
+	 * writes the results to \a output (which can be the same as \a input).
+	 *
+	 * The results are the same as calling calculate() for each value.
+	 *
+	 */
+	void calculate(const float * input, float * output, u32 count);
+
+	using SimpleFilter<float, LowPassFilterF32>::calculate;
+
 private:
 	float m_alpha;
 };
@@ -251,11 +301,126 @@ public:
 
 	float calculate(float input) override;
 
+	/*! \details Filters \a count values from \a input and
+	 * writes the results to \a output (which can be the same as \a input).
+	 *
+	 * The results are the same as calling calculate() for each value.
+	 *
+	 */
+	void calculate(const float * input, float * output, u32 count);
+
+	using SimpleFilter<float, HighPassFilterF32>::calculate;
+
 private:
 	float m_last_input;
 	float m_r_value;
 };
 
+/*! \brief Multi-channel LowPassFilterF32 class */
+/*! \details This class runs a LowPassFilterF32 on each of
+ * channel_count() channels of interleaved samples (such as
+ * an ADC scanning several inputs).
+ *
+ * The channels of each frame are filtered together so the
+ * compiler can use SIMD instructions on processors that
+ * have them. The results are the same as using a
+ * LowPassFilterF32 for each channel.
+ *
+ * ```
+ * //md2code:main
+ * MultiChannelLowPassFilterF32 filter(8, 0.0f, 0.1f);
+ * float samples[8*16]; //16 frames of 8 channels
+ * memset(samples, 0, sizeof(samples));
+ * filter.calculate(samples, samples, 16);
+ * printf("Channel 3 is %0.2f\n", filter.present_value(3));
+ * ```
+ *
+ */
+class MultiChannelLowPassFilterF32 {
+public:
+	/*! \details Constructs a filter for \a channel_count channels. */
+	MultiChannelLowPassFilterF32(
+			u32 channel_count,
+			float start = 0.0f,
+			float alpha = 1.0f
+			);
+
+	/*! \details Sets the alpha value of every channel (see LowPassFilterF32). */
+	void set_alpha(float value);
+
+	/*! \details Sets the alpha value of \a channel. */
+	void set_alpha(u32 channel, float value);
+
+	/*! \details Sets the present value of every channel to \a start. */
+	void reset(float start);
+
+	/*! \details Filters \a frame_count frames of interleaved samples.
+	 *
+	 * @param input Samples ordered by frame then channel
+	 * @param output Results in the same order (can be the same as \a input)
+	 * @param frame_count The number of frames (samples per channel)
+	 *
+	 */
+	void calculate(const float * input, float * output, u32 frame_count);
+
+	u32 channel_count() const { return m_present_value.count(); }
+
+	/*! \details Returns the present value of \a channel. */
+	float present_value(u32 channel) const { return m_present_value.at(channel); }
+
+	/*! \details Sets the present value of \a channel. */
+	void set_present_value(u32 channel, float value){ m_present_value.at(channel) = value; }
+
+private:
+	var::Vector<float> m_present_value;
+	var::Vector<float> m_alpha;
+};
+
+/*! \brief Multi-channel HighPassFilterF32 class */
+/*! \details This class runs a HighPassFilterF32 on each of
+ * channel_count() channels of interleaved samples.
+ *
+ * See MultiChannelLowPassFilterF32 for details.
+ *
+ */
+class MultiChannelHighPassFilterF32 {
+public:
+	/*! \details Constructs a filter for \a channel_count channels. */
+	MultiChannelHighPassFilterF32(
+			u32 channel_count,
+			float start,
+			float r_value
+			);
+
+	/*! \details Resets every channel to the given start value. */
+	void reset(float start);
+
+	/*! \details Sets the r value of every channel (see HighPassFilterF32). */
+	void set_r_value(float r_value);
+
+	/*! \details Sets the r value of \a channel. */
+	void set_r_value(u32 channel, float r_value);
+
+	/*! \details Filters \a frame_count frames of interleaved samples.
+	 *
+	 * @param input Samples ordered by frame then channel
+	 * @param output Results in the same order (can be the same as \a input)
+	 * @param frame_count The number of frames (samples per channel)
+	 *
+	 */
+	void calculate(const float * input, float * output, u32 frame_count);
+
+	u32 channel_count() const { return m_present_value.count(); }
+
+	/*! \details Returns the present value of \a channel. */
+	float present_value(u32 channel) const { return m_present_value.at(channel); }
+
+private:
+	var::Vector<float> m_present_value;
+	var::Vector<float> m_last_input;
+	var::Vector<float> m_r_value;
+};
+
 
 
 }
@@ -0,0 +1,46 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_CALC_FILTERTEST_HPP_
+#define SAPI_CALC_FILTERTEST_HPP_
+
+#include "../test/Test.hpp"
+
+namespace calc {
+
+/*! \brief Filter Test Class
+ * \details The FilterTest class checks that the block, ring and
+ * multi-channel versions of calculate() for the filters in
+ * Filter.hpp and Ema.hpp give exactly the same results (bit for bit)
+ * as calling calculate() for each value.
+ *
+ * This header is not included by `sapi/calc.hpp` so applications
+ * that don't run tests don't need the test framework.
+ *
+ * ```
+ * #include <sapi/calc/FilterTest.hpp>
+ *
+ * Test::initialize(Test::Name("filter-test"), Test::Version("0.1"));
+ * {
+ *   FilterTest test;
+ *   test.execute(Test::execute_api);
+ * }
+ * Test::finalize();
+ * ```
+ *
+ */
+class FilterTest : public test::Test {
+public:
+	FilterTest() : test::Test("calc::Filter"){}
+
+	bool execute_class_api_case() override;
+
+private:
+	bool execute_low_pass_f32_case();
+	bool execute_high_pass_f32_case();
+	bool execute_low_pass_s32_case();
+	bool execute_ema_case();
+};
+
+}
+
+#endif // SAPI_CALC_FILTERTEST_HPP_
@@ -5,6 +5,7 @@
 
 #include "../api/CalcObject.hpp"
 #include "../arg/Argument.hpp"
+#include <limits>
 
 namespace calc {
 
@@ -14,6 +15,11 @@ namespace calc {
  * must be signed or overflow errors will cause
  * problems with the calculations.
  *
+ * By default, calculate() searches the table from the first
+ * entry. Large tables should use mode_binary, mode_uniform (if the
+ * x values are evenly spaced) or mode_hint (if consecutive
+ * inputs are close together, like ADC samples).
+ *
  * ```
  * //md2code:include
  * #include <sapi/calc.hpp>
@@ -36,52 +42,203 @@ namespace calc {
  */
 template<typename T>class Lookup : public api::WorkObject {
 public:
+
+	/*! \details Ways to find the table segment that brackets x. */
+	enum mode {
+		mode_linear /*! Search from the first entry (default) */,
+		mode_binary /*! Binary search: O(log n) for large tables */,
+		mode_uniform /*! Calculate the segment: O(1) but x values must be evenly spaced */,
+		mode_hint /*! Search from the last segment used: fast when x changes slowly */
+	};
+
 	/*! \details Constructs a lookup table object.
 	 *
 	 * @param table
 	 */
 	Lookup(
 			const T * table /*! A pointer to a table with x and y values alternating, x values must be in ascending order */,
-			u32 count /*! The number of entries in the table */
+			u32 count /*! The number of entries in the table */,
+			enum mode mode = mode_linear /*! How to find the segment that brackets x */
 			){
 		m_table = table;
 		m_count = count;
+		set_mode(mode);
 	}
 
+	/*! \details Sets how calculate() finds the segment that brackets x.
+	 *
+	 * All modes give the same results except mode_uniform
+	 * which requires the x values to be evenly spaced.
+	 *
+	 */
+	Lookup & set_mode(enum mode value){
+		m_mode = value;
+		m_hint = 0;
+		if( m_count > 1 ){
+			m_step = (x_at(m_count-1) - x_at(0)) / static_cast<T>(m_count-1);
+			if( !std::numeric_limits<T>::is_integer && (m_step != 0) ){
+				m_inverse_step = static_cast<T>(1) / m_step;
+			}
+		}
+		return *this;
+	}
+
+	enum mode mode() const { return m_mode; }
+
 	/*! \details Calculates the y value using linear interpolation.
 	 *
 	 * @param x Input value
 	 * @return y Value calculated using linear interpolation
 	 */
 	T calculate(T x){
-		unsigned int p1, p2;
-		unsigned int i;
-		T delta_x, delta_y;
-		T output;
-
-		i = 0;
-		while( (x > m_table[i+2]) && (i < (m_count-2)*2) ){
-			i+=2;
+		if( m_count < 2 ){
+			return m_count ? m_table[1] : 0;
 		}
 
-		p1 = i;
-		p2 = i+2;
+		switch(m_mode){
+			case mode_binary: return interpolate(binary_segment(x), x);
+			case mode_uniform: return interpolate(uniform_segment(x), x);
+			case mode_hint: return interpolate(hint_segment(x), x);
+			case mode_linear: break;
+		}
+		return interpolate(linear_segment(x), x);
+	}
 
-		//now calculate the slope between the y values
-		delta_x = m_table[p1] - m_table[p2];
-		if( delta_x == 0 ){
-			return m_table[p1+1];
+	/*! \details Calculates \a count y values.
+	 *
+	 * @param input A pointer to \a count x values
+	 * @param output A pointer to memory for \a count y values
+	 * @param count The number of values to calculate
+	 *
+	 * This is faster than calling calculate() for each
+	 * value because the mode is only checked once.
+	 *
+	 */
+	void calculate(const T * input, T * output, u32 count){
+		if( m_count < 2 ){
+			for(u32 i=0; i < count; i++){
+				output[i] = m_count ? m_table[1] : 0;
+			}
+			return;
 		}
-		delta_y = m_table[p1+1] - m_table[p2+1];
-		output = ((x - m_table[p1]) * delta_y + delta_x/2) / delta_x + m_table[p1+1];
 
+		switch(m_mode){
+			case mode_binary:
+				for(u32 i=0; i < count; i++){
+					output[i] = interpolate(binary_segment(input[i]), input[i]);
+				}
+				return;
+			case mode_uniform:
+				for(u32 i=0; i < count; i++){
+					output[i] = interpolate(uniform_segment(input[i]), input[i]);
+				}
+				return;
+			case mode_hint:
+				for(u32 i=0; i < count; i++){
+					output[i] = interpolate(hint_segment(input[i]), input[i]);
+				}
+				return;
+			case mode_linear:
+				break;
+		}
 
-		return output;
+		for(u32 i=0; i < count; i++){
+			output[i] = interpolate(linear_segment(input[i]), input[i]);
+		}
 	}
 
 private:
 	const T * m_table;
 	unsigned int m_count;
+	enum mode m_mode;
+	u32 m_hint;
+	T m_step = 0;
+	T m_inverse_step = 0;
+
+	T x_at(u32 segment) const { return m_table[segment*2]; }
+
+	//each search returns the first segment where x <= the end of the segment
+	//or the last segment if x is past the end of the table
+
+	u32 linear_segment(T x) const {
+		u32 i = 0;
+		while( (x > x_at(i+1)) && (i < m_count-2) ){
+			i++;
+		}
+		return i;
+	}
+
+	u32 binary_segment(T x) const {
+		u32 first = 0;
+		u32 length = m_count-1;
+		while( length > 0 ){
+			const u32 half = length / 2;
+			if( x > x_at(first + half + 1) ){
+				first += half + 1;
+				length -= half + 1;
+			} else {
+				length = half;
+			}
+		}
+		return first < m_count-2 ? first : m_count-2;
+	}
+
+	u32 uniform_segment(T x) const {
+		const T offset = x - x_at(0);
+		if( (offset <= 0) || (m_step == 0) ){
+			return 0;
+		}
+
+		u32 result;
+		if( std::numeric_limits<T>::is_integer ){
+			result = static_cast<u32>(offset / m_step);
+		} else {
+			const T value = offset * m_inverse_step;
+			result = value < static_cast<T>(m_count) ? static_cast<u32>(value) : m_count;
+		}
+
+		if( result > m_count-2 ){
+			result = m_count-2;
+		}
+
+		//the estimate can be off by one at the ends of a segment
+		if( (result > 0) && (x <= x_at(result)) ){
+			result--;
+		} else if( (result < m_count-2) && (x > x_at(result+1)) ){
+			result++;
+		}
+		return result;
+	}
+
+	u32 hint_segment(T x){
+		u32 i = m_hint;
+		while( (i < m_count-2) && (x > x_at(i+1)) ){
+			i++;
+		}
+		while( (i > 0) && (x <= x_at(i)) ){
+			i--;
+		}
+		m_hint = i;
+		return i;
+	}
+
+	T interpolate(u32 segment, T x) const {
+		const T * p1 = m_table + segment*2;
+		const T * p2 = p1 + 2;
+
+		//now calculate the slope between the y values
+		const T delta_x = p1[0] - p2[0];
+		if( delta_x == 0 ){
+			return p1[1];
+		}
+		const T delta_y = p1[1] - p2[1];
+
+		if( std::numeric_limits<T>::is_integer ){
+			//round to the nearest integer
+			return ((x - p1[0]) * delta_y + delta_x/2) / delta_x + p1[1];
+		}
+		return (x - p1[0]) * delta_y / delta_x + p1[1];
+	}
 };
 
 }
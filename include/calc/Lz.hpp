@@ -0,0 +1,284 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_CALC_LZ_HPP_
+#define SAPI_CALC_LZ_HPP_
+
+#include "../api/CalcObject.hpp"
+#include "../var/Data.hpp"
+#include "../fs/File.hpp"
+
+#if defined __link
+#define SAPI_LZ_DEFAULT_BLOCK_SIZE (64*1024)
+#define SAPI_LZ_MAXIMUM_BLOCK_SIZE (4*1024*1024)
+#else
+#define SAPI_LZ_DEFAULT_BLOCK_SIZE 4096
+#define SAPI_LZ_MAXIMUM_BLOCK_SIZE (64*1024)
+#endif
+
+namespace calc {
+
+/*! \brief LZ Compression Class
+ * \details This class compresses and decompresses blocks of
+ * data using the LZ4 block format. The compressor favors speed
+ * over ratio (it uses a single hash table and skips ahead
+ * faster in data that doesn't compress).
+ *
+ * The compressed blocks can be decompressed by any LZ4 block
+ * decoder (and vice versa). Use LzFile to compress a stream.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/calc.hpp>
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * Data log_data(4096);
+ * log_data.fill<u8>(0x20);
+ * Data compressed = Lz::compress(log_data);
+ * Data original = Lz::decompress(
+ *   compressed,
+ *   Lz::Size(log_data.size())
+ *   );
+ * ```
+ *
+ */
+class Lz {
+public:
+
+	using Size = var::Reference::Size;
+
+	/*! \details Returns the largest number of bytes that
+	 * compressing \a nbyte bytes can produce.
+	 */
+	static u32 calc_bound(u32 nbyte){
+		return nbyte + nbyte/255 + 16;
+	}
+
+	/*! \details Compresses a block of data.
+	 *
+	 * @param dest A pointer to the destination memory
+	 * @param dest_size The size of \a dest (calc_bound() always works)
+	 * @param src A pointer to the source data
+	 * @param src_size The number of bytes to compress
+	 * @return The number of compressed bytes or less than zero if \a dest is too small
+	 *
+	 */
+	static int compress(
+			void * dest,
+			u32 dest_size,
+			const void * src,
+			u32 src_size
+			);
+
+	/*! \details Decompresses a block of data.
+	 *
+	 * @param dest A pointer to the destination memory
+	 * @param dest_size The size of \a dest
+	 * @param src A pointer to the compressed data
+	 * @param src_size The number of compressed bytes
+	 * @return The number of decompressed bytes or less than zero if
+	 * the data is corrupt or doesn't fit in \a dest
+	 *
+	 * The compressed data is checked so that corrupt data never
+	 * causes a read or write outside of \a src or \a dest.
+	 *
+	 */
+	static int decompress(
+			void * dest,
+			u32 dest_size,
+			const void * src,
+			u32 src_size
+			);
+
+	/*! \details Returns a compressed copy of \a input. */
+	static var::Data compress(const var::Reference & input);
+
+	/*! \details Returns the decompressed copy of \a input.
+	 *
+	 * @param input The compressed data
+	 * @param size The size of the original data
+	 * @return The decompressed data (empty if \a input is corrupt)
+	 *
+	 */
+	static var::Data decompress(
+			const var::Reference & input,
+			Size size
+			);
+
+};
+
+/*! \brief LZ Compressed File Class
+ * \details The LzFile class compresses data written to another
+ * fs::File and decompresses data read from it.
+ *
+ * The data is split into blocks of block_size() bytes and
+ * each block is compressed with Lz. Blocks that don't get
+ * smaller are stored as is. The stream looks like this
+ * (all values are little endian):
+ *
+ * | Field | Size | Description |
+ * |-------|------|-------------|
+ * | magic | 4 | `SLZ1` |
+ * | block size | 4 | the size of an uncompressed block |
+ * | block header | 4 | bit 31 is set if the block is stored, bits 0 to 30 are the size of the block data |
+ * | block data | varies | the compressed (or stored) block |
+ * | ... | | more blocks |
+ * | end mark | 4 | zero |
+ *
+ * An LzFile can either write or read (whichever is used first).
+ * When writing, close() must be called (the destructor calls it)
+ * to write the last block and the end mark.
+ *
+ * ```
+ * //md2code:main
+ * File log_file;
+ * log_file.create("/home/log.txt.lz", File::IsOverwrite(true));
+ * LzFile compressed_file(log_file);
+ * compressed_file.write(String("log entry\n"));
+ * compressed_file.close();
+ * ```
+ *
+ * The underlying file must remain valid for the life
+ * of the LzFile. Closing the LzFile does not close the
+ * underlying file.
+ *
+ */
+class LzFile : public fs::File {
+public:
+
+	/*! \details Constructs an object that compresses to or decompresses from \a file.
+	 *
+	 * @param file The underlying file
+	 * @param block_size The size of the blocks when writing (reading uses the size in the stream)
+	 *
+	 * The block size is limited to SAPI_LZ_MAXIMUM_BLOCK_SIZE. Reading a
+	 * stream with larger blocks fails without allocating them.
+	 *
+	 */
+	explicit LzFile(
+			const fs::File & file,
+			Size block_size = Size(SAPI_LZ_DEFAULT_BLOCK_SIZE)
+			);
+
+	virtual ~LzFile(){
+		close();
+		m_fd = -1;
+	}
+
+	/*! \details Returns an error. The underlying
+	 * file must be opened instead.
+	 */
+	int open(
+			const var::String & path,
+			const fs::OpenFlags & flags
+			) override {
+		MCU_UNUSED_ARGUMENT(path);
+		MCU_UNUSED_ARGUMENT(flags);
+		return set_error_number_if_error(api::error_code_fs_unsupported_operation);
+	}
+
+	/*! \details Writes the last block and the end mark if
+	 * the file has been written.
+	 *
+	 * @return Zero on success
+	 *
+	 */
+	int close() override;
+
+	/*! \details Reads and decompresses up to \a nbyte bytes.
+	 *
+	 * @return The number of decompressed bytes or zero at the end of the stream
+	 *
+	 */
+	int read(
+			void * buf,
+			Size nbyte
+			) const override;
+
+	/*! \details Compresses \a nbyte bytes and writes them when a block is full. */
+	int write(
+			const void * buf,
+			Size nbyte
+			) const override;
+
+	/*! \details Returns an error (the stream can't be seeked). */
+	int seek(
+			int location,
+			enum whence whence = whence_set
+			) const override {
+		MCU_UNUSED_ARGUMENT(location);
+		MCU_UNUSED_ARGUMENT(whence);
+		return set_error_number_if_error(api::error_code_fs_unsupported_operation);
+	}
+
+	int ioctl(
+			IoRequest request,
+			IoArgument argument
+			) const override {
+		return m_file.ioctl(request, argument);
+	}
+
+	/*! \details Returns zero (the decompressed size isn't known). */
+	u32 size() const override { return 0; }
+
+	using File::read;
+	using File::write;
+
+	/*! \details Compresses and writes any pending data as a
+	 * (possibly short) block.
+	 *
+	 * This is useful to make sure data sent over a slow link
+	 * arrives without waiting for the block to fill.
+	 *
+	 */
+	int flush() const;
+
+	/*! \details Returns the size of an uncompressed block. */
+	u32 block_size() const { return m_block_size; }
+
+	/*! \details Returns the number of uncompressed bytes written or read. */
+	u32 uncompressed_size() const { return m_uncompressed_size; }
+
+	/*! \details Returns the number of bytes written to or read from the underlying file. */
+	u32 compressed_size() const { return m_compressed_size; }
+
+	/*! \details Accesses the underlying file. */
+	const fs::File & file() const { return m_file; }
+
+private:
+	/*! \cond */
+	enum mode {
+		mode_none,
+		mode_write,
+		mode_read,
+		mode_end
+	};
+
+	enum {
+		header_size = 4,
+		stored_flag = 0x80000000
+	};
+
+	const fs::File & m_file;
+	mutable enum mode m_mode = mode_none;
+	mutable u32 m_block_size;
+	mutable var::Data m_block; //uncompressed data
+	mutable var::Data m_compressed_block; //block header plus compressed data
+	mutable u32 m_head = 0; //next byte to read from m_block
+	mutable u32 m_tail = 0; //end of valid data in m_block
+	mutable u32 m_uncompressed_size = 0;
+	mutable u32 m_compressed_size = 0;
+
+	int start_write() const;
+	int start_read() const;
+	int read_block() const;
+	int write_underlying(const void * buf, u32 nbyte) const;
+	int read_underlying(void * buf, u32 nbyte) const;
+	/*! \endcond */
+};
+
+}
+
+#endif /* SAPI_CALC_LZ_HPP_ */
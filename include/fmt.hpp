@@ -12,6 +12,8 @@ namespace fmt {}
 #include "fmt/Wav.hpp"
 #include "fmt/Svic.hpp"
 #include "fmt/Csv.hpp"
+#include "fmt/CsvReader.hpp"
+#include "fmt/CsvWriter.hpp"
 
 using namespace fmt;
 
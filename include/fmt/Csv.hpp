@@ -5,6 +5,8 @@
 #include "../var/Matrix.hpp"
 #include "../var/String.hpp"
 #include "../var/Tokenizer.hpp"
+#include "CsvReader.hpp"
+#include "CsvWriter.hpp"
 
 namespace fmt {
 
@@ -15,11 +17,26 @@ public:
 
 	Csv(fs::File & file, const var::String& delimeters);
 
+	/*! \details Loads the file at \a file_path in to a matrix.
+	 *
+	 * Every character in \a delimeters separates fields (such as ",;").
+	 *
+	 * The file is read a block at a time (see CsvReader) so only
+	 * the matrix needs to fit in memory. Use a CsvReader directly to
+	 * process files that are larger than the available memory.
+	 *
+	 */
 	static var::Matrix<var::String> load(
 			const var::String & file_path,
 			Delimeters delimeters = Delimeters(",")
 			);
 
+	/*! \details Saves \a m_matrix to a new file at \a file_path
+	 * using the first character of \a delimeters to separate fields.
+	 *
+	 * @return Zero on success or less than zero for an error
+	 *
+	 */
 	static int save(
 			const var::String & file_path,
 			const var::Matrix<var::String> & m_matrix,
@@ -39,7 +56,11 @@ private:
 
 	fs::File & m_file;
 	var::StringList	m_header;
-	var::String m_delimeters = ",";
+	CsvReader m_reader;
+
+	static char delimeter(const var::String & delimeters){
+		return delimeters.length() ? delimeters.at(0) : ',';
+	}
 
 };
 
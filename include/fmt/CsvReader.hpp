@@ -0,0 +1,236 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_FMT_CSVREADER_HPP_
+#define SAPI_FMT_CSVREADER_HPP_
+
+#include "../fs/File.hpp"
+#include "../var/CharacterSet.hpp"
+#include "../var/String.hpp"
+#include "../var/StringView.hpp"
+#include "../var/Vector.hpp"
+
+namespace fmt {
+
+/*! \brief CSV Reader Class
+ * \details The CsvReader class reads comma separated values
+ * from an fs::File one row at a time.
+ *
+ * The file is read through an fs::BufferedFile in blocks of
+ * Options::buffer_size() bytes so files that are much larger than
+ * the available memory can be processed. Quoted fields follow RFC 4180: they may contain the
+ * delimiter, line breaks and doubled quotes ("").
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/fmt.hpp>
+ * #include <sapi/fs.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * File samples;
+ * samples.open("/home/samples.csv", OpenFlags::read_only());
+ * CsvReader reader(samples);
+ * reader.read_header();
+ *
+ * //numeric columns are parsed directly in to vectors
+ * Vector<float> time;
+ * Vector<s32> value;
+ * reader.read_columns({
+ *   CsvReader::Column::real("time", time),
+ *   CsvReader::Column::integer("value", value)
+ * });
+ * ```
+ *
+ */
+class CsvReader : public api::WorkObject {
+public:
+
+	class Options {
+	public:
+		Options(){}
+	private:
+		/*! \cond */
+		API_ACCESS_FUNDAMENTAL(Options,char,delimeter,',');
+		API_ACCESS_FUNDAMENTAL(Options,char,quote,'"');
+		API_ACCESS_FUNDAMENTAL(Options,u32,buffer_size,4096);
+		/*! \endcond */
+
+		/*! \details If this isn't empty, every character in it separates
+		 * fields (such as ",;") and delimeter() is not used.
+		 */
+		API_ACCESS_COMPOUND(Options,var::String,delimeters);
+	};
+
+	/*! \brief CSV Row Class
+	 * \details A Row holds the fields of the last row that
+	 * was read. The fields are only valid until the next
+	 * row is read.
+	 *
+	 */
+	class Row {
+	public:
+
+		/*! \details Returns the number of fields in the row. */
+		u32 count() const { return m_field_list.count(); }
+		bool is_empty() const { return m_field_list.count() == 0; }
+
+		/*! \details Returns the field at \a offset (or an empty view if
+		 * the row doesn't have that many fields).
+		 *
+		 * Quotes are removed from the value and the value
+		 * is followed by a null terminator.
+		 *
+		 */
+		var::StringView at(u32 offset) const {
+			if( offset < m_field_list.count() ){
+				return m_field_list.at(offset);
+			}
+			return var::StringView();
+		}
+
+		/*! \details Returns the field at \a offset as an integer (zero if it is missing). */
+		s32 to_integer(u32 offset) const;
+
+		/*! \details Returns the field at \a offset as a float (zero if it is missing). */
+		float to_float(u32 offset) const;
+
+		/*! \details Copies all the fields to a new list. */
+		var::StringList to_string_list() const;
+
+	private:
+		friend class CsvReader;
+		var::Vector<var::StringView> m_field_list;
+	};
+
+	/*! \brief CSV Column Class
+	 * \details A Column specifies where read_columns() should
+	 * store the values of one column of the file.
+	 *
+	 */
+	class Column {
+	public:
+
+		enum type {
+			type_integer,
+			type_real,
+			type_string
+		};
+
+		static Column integer(u32 offset, var::Vector<s32> & destination){
+			return Column(var::String(), offset, type_integer, &destination);
+		}
+
+		static Column integer(const var::String & name, var::Vector<s32> & destination){
+			return Column(name, 0, type_integer, &destination);
+		}
+
+		static Column real(u32 offset, var::Vector<float> & destination){
+			return Column(var::String(), offset, type_real, &destination);
+		}
+
+		static Column real(const var::String & name, var::Vector<float> & destination){
+			return Column(name, 0, type_real, &destination);
+		}
+
+		static Column string(u32 offset, var::StringList & destination){
+			return Column(var::String(), offset, type_string, &destination);
+		}
+
+		static Column string(const var::String & name, var::StringList & destination){
+			return Column(name, 0, type_string, &destination);
+		}
+
+		/*! \details Returns the header name (empty if the column uses an offset). */
+		const var::String & name() const { return m_name; }
+		u32 offset() const { return m_offset; }
+		enum type type() const { return m_type; }
+
+	private:
+		friend class CsvReader;
+
+		Column(
+				const var::String & name,
+				u32 offset,
+				enum type type,
+				void * destination
+				) : m_name(name), m_offset(offset), m_type(type), m_destination(destination){}
+
+		var::String m_name;
+		u32 m_offset;
+		enum type m_type;
+		void * m_destination;
+	};
+
+	explicit CsvReader(
+			const fs::File & file,
+			const Options & options = Options()
+			);
+
+	/*! \details Reads the next row and saves it as the header.
+	 *
+	 * @return The number of columns or less than zero for an error
+	 *
+	 */
+	int read_header();
+
+	/*! \details Reads the next row from the file.
+	 *
+	 * Empty lines are skipped.
+	 *
+	 * @return The number of fields in the row, zero at the end
+	 * of the file or less than zero for an error
+	 *
+	 */
+	int read_row();
+
+	/*! \details Returns the last row that was read. */
+	const Row & row() const { return m_row; }
+
+	/*! \details Returns the header (see read_header()). */
+	const var::StringList & header() const { return m_header; }
+
+	/*! \details Returns the offset of the column named \a name or
+	 * header().count() if the header doesn't have the column.
+	 *
+	 */
+	u32 column_offset(const var::StringView & name) const;
+
+	/*! \details Reads the remaining rows and appends the values
+	 * of each column in \a column_list to the column's destination.
+	 *
+	 * Only the fields that are specified are converted so numeric
+	 * columns are never stored as strings. A field that is missing
+	 * from a row is stored as zero (or an empty string).
+	 *
+	 * @return The number of rows that were read or less than zero
+	 * if a column name is not in the header or the file is not valid
+	 *
+	 */
+	int read_columns(const var::Vector<Column> & column_list);
+
+	/*! \details Returns the number of rows that have been read (including the header). */
+	u32 row_count() const { return m_row_count; }
+
+private:
+	/*! \cond */
+	fs::BufferedFile m_file;
+	Options m_options;
+	var::CharacterSet m_delimeter_set;
+	var::CharacterSet m_special_set;
+	bool m_is_end_of_file = false;
+	u32 m_row_count = 0;
+
+	//the fields of the current row (without quotes and null terminated)
+	var::String m_record;
+	var::Vector<u32> m_field_offset_list;
+	Row m_row;
+	var::StringList m_header;
+
+	int fill_buffer();
+	void end_field();
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_FMT_CSVREADER_HPP_
@@ -0,0 +1,104 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_FMT_CSVWRITER_HPP_
+#define SAPI_FMT_CSVWRITER_HPP_
+
+#include "../fs/File.hpp"
+#include "../var/CharacterSet.hpp"
+#include "../var/Data.hpp"
+#include "../var/Matrix.hpp"
+#include "../var/String.hpp"
+#include "../var/StringView.hpp"
+
+namespace fmt {
+
+/*! \brief CSV Writer Class
+ * \details The CsvWriter class writes comma separated values
+ * to an fs::File.
+ *
+ * Rows are collected in a buffer of Options::buffer_size() bytes
+ * that is written to the file when it fills up, when flush() is
+ * called, or when the writer is destroyed. Fields that contain the
+ * delimiter, a quote or a line break are quoted as in RFC 4180.
+ *
+ * ```
+ * //md2code:main
+ * File samples;
+ * samples.create("/home/samples.csv", File::IsOverwrite(true));
+ * CsvWriter writer(samples);
+ * writer.write_row(StringList({"time", "value"}));
+ * for(u32 i=0; i < 100; i++){
+ *   writer.write_field(i*0.01f);
+ *   writer.write_field(s32(i));
+ *   writer.end_row();
+ * }
+ * ```
+ *
+ */
+class CsvWriter : public api::WorkObject {
+public:
+
+	class Options {
+	public:
+		Options() : m_line_ending("\n"){}
+	private:
+		/*! \cond */
+		API_ACCESS_FUNDAMENTAL(Options,char,delimeter,',');
+		API_ACCESS_FUNDAMENTAL(Options,char,quote,'"');
+		API_ACCESS_FUNDAMENTAL(Options,u32,buffer_size,4096);
+		API_ACCESS_COMPOUND(Options,var::String,line_ending);
+		/*! \endcond */
+	};
+
+	explicit CsvWriter(
+			const fs::File & file,
+			const Options & options = Options()
+			);
+
+	/*! \details Writes any buffered data to the file. */
+	~CsvWriter();
+
+	CsvWriter(const CsvWriter & a) = delete;
+	CsvWriter & operator=(const CsvWriter & a) = delete;
+
+	/*! \details Writes a field to the current row.
+	 *
+	 * @return Zero on success or less than zero if the file could not be written
+	 *
+	 */
+	int write_field(const var::StringView & value);
+	int write_field(s32 value);
+	int write_field(float value);
+
+	/*! \details Ends the current row. */
+	int end_row();
+
+	/*! \details Writes all the fields in \a row and ends the row. */
+	int write_row(const var::StringList & row);
+
+	/*! \details Writes a row of a matrix (such as the output of Csv::load()). */
+	int write_row(const var::Matrix<var::String>::ConstRow & row);
+
+	/*! \details Writes the buffered data to the file. */
+	int flush();
+
+	/*! \details Returns the number of rows that have been written. */
+	u32 row_count() const { return m_row_count; }
+
+private:
+	/*! \cond */
+	const fs::File & m_file;
+	Options m_options;
+	var::CharacterSet m_quote_set;
+	var::Data m_buffer;
+	u32 m_size = 0;
+	u32 m_row_count = 0;
+	bool m_is_row_started = false;
+
+	int write(const char * data, u32 size);
+	int write_unquoted_field(const char * data, u32 size);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_FMT_CSVWRITER_HPP_
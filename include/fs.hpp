@@ -12,6 +12,8 @@ namespace fs {}
 
 #if !defined __link
 #include "fs/Aio.hpp"
+#else
+#include "fs/MappedFile.hpp"
 #endif
 
 #include "fs/Stat.hpp"
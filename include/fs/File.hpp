@@ -12,6 +12,7 @@
 
 #include "../var/Data.hpp"
 #include "../var/String.hpp"
+#include "../var/Vector.hpp"
 #include "../sys/ProgressCallback.hpp"
 
 #if !defined __link
@@ -481,18 +482,48 @@ public:
 		return write(source_file, page_size, size);
 	}
 
+	/*! \brief Write Options
+	 * \details The WriteOptions class specifies how
+	 * the contents of one file are written to another.
+	 *
+	 * If `pipelined` is set, a reader thread fills up to
+	 * `pipeline_depth` pages from the source file while
+	 * the calling thread writes them to this file. This keeps
+	 * a slow transport (such as a Link connection) busy rather
+	 * than waiting for each read to complete before writing.
+	 *
+	 * ```
+	 * File destination;
+	 * File source;
+	 * //open/create both files
+	 * destination.write(
+	 *   source,
+	 *   File::WriteOptions()
+	 *     .set_page_size(4096)
+	 *     .set_pipelined()
+	 *     .set_pipeline_depth(8)
+	 *   );
+	 * ```
+	 *
+	 * When a progress callback is provided, the achieved
+	 * rate (bytes per second) is available using
+	 * sys::ProgressCallback::rate().
+	 *
+	 */
 	class WriteOptions {
 	public:
 		API_ACCESS_FUNDAMENTAL(WriteOptions,u32,location,static_cast<u32>(-1));
 		API_ACCESS_FUNDAMENTAL(WriteOptions,u32,page_size,SAPI_LINK_DEFAULT_PAGE_SIZE);
 		API_ACCESS_FUNDAMENTAL(WriteOptions,size_t,size,static_cast<size_t>(-1));
 		API_ACCESS_FUNDAMENTAL(WriteOptions,const sys::ProgressCallback*,progress_callback,nullptr);
+		API_ACCESS_BOOL(WriteOptions,pipelined,false);
+		API_ACCESS_FUNDAMENTAL(WriteOptions,u32,pipeline_depth,4);
 	};
 
 	int write(
 			const File& source_file,
 			const WriteOptions & options
-			);
+			) const;
 
 	int write(
 			const File & source_file,
@@ -519,8 +550,11 @@ public:
 	 * @param timeout_msec Timeout in ms if line does not arrive
 	 * @param terminator Terminating character of the line (default is newline)
 	 * @return Number of bytes received
+	 *
+	 * This method reads one byte at a time. Use fs::BufferedFile
+	 * to read lines with fewer calls to the underlying file.
 	 */
-	int readline(char * buf, int nbyte, int timeout_msec, char terminator = '\n') const;
+	virtual int readline(char * buf, int nbyte, int timeout_msec, char terminator = '\n') const;
 
 	const File& operator<<(const var::Reference & a) const {
 		write(a); return *this;
@@ -548,7 +582,14 @@ public:
 	/*! \details Reads a line in to the var::String until end-of-file or \a term is reached. */
 	var::String gets(char term = '\n') const;
 
-	const char * gets(var::String & s, char term = '\n') const;
+	/*! \details Reads a line in to \a s until end-of-file or \a term is reached.
+	 *
+	 * @return A pointer to the string or nullptr if end-of-file was reached before \a term
+	 *
+	 * This method reads one byte at a time. Use fs::BufferedFile
+	 * to read lines with fewer calls to the underlying file.
+	 */
+	virtual const char * gets(var::String & s, char term = '\n') const;
 
 
 	API_DEPRECATED("Use gets(var::String & s) instead")
@@ -760,6 +801,11 @@ protected:
 private:
 
 
+	int write_pipelined(
+			const File & source_file,
+			const WriteOptions & options
+			) const;
+
 	static int copy(
 			Source source,
 			Destination dest,
@@ -788,11 +834,33 @@ private:
  * that can be passed to methods that read/write
  * data from the file.
  *
+ * When writing in append mode, the growth_policy()
+ * determines how memory is added:
+ *
+ * - growth_policy_geometric: the capacity is doubled when more is needed
+ * - growth_policy_fixed_chunk: the capacity grows in growth_chunk_size() blocks
+ * - growth_policy_chunk_list: writes are stored in a list of growth_chunk_size()
+ *   blocks that are joined in to one contiguous buffer the first time
+ *   the data is read, sought or accessed with data()
+ *
+ * ```
+ * DataFile data_file(OpenFlags::append_read_write());
+ * data_file.set_growth_policy(DataFile::growth_policy_chunk_list);
+ * data_file.reserve(expected_size);
+ * //write to the file many times
+ * var::Data contents = data_file.release_data();
+ * ```
  *
  */
 class DataFile : public File {
 public:
 
+	enum growth_policy {
+		growth_policy_geometric /*! Double the capacity when more is needed (default) */,
+		growth_policy_fixed_chunk /*! Grow the capacity by growth_chunk_size() bytes at a time */,
+		growth_policy_chunk_list /*! Store appended data in a list of growth_chunk_size() byte blocks */
+	};
+
 	/*! \details Constructs a data file. */
 	DataFile(
 			const OpenFlags & flags = OpenFlags::read_write()
@@ -876,7 +944,7 @@ public:
 	 * file (size of the data).
 	 *
 	 */
-	u32 size() const override { return data().size(); }
+	u32 size() const override { return m_data.size() + m_chunk_list_size; }
 
 	using File::read;
 	using File::write;
@@ -886,14 +954,42 @@ public:
 	const OpenFlags & flags() const { return m_open_flags; }
 
 	/*! \details Accesses (read-only) the member data object. */
-	const var::Data & data() const { return m_data; }
+	const var::Data & data() const { join_chunk_list(); return m_data; }
 	/*! \details Accesses the member data object. */
-	var::Data & data(){ return m_data; }
+	var::Data & data(){ join_chunk_list(); return m_data; }
+
+	/*! \details Reserves memory for \a size bytes.
+	 *
+	 * Use this when the final size of the file is known (or estimated)
+	 * before writing to avoid growing the data more than once.
+	 *
+	 */
+	DataFile & reserve(u32 size){
+		m_data.reserve(size);
+		return *this;
+	}
+
+	/*! \details Moves the data out of this object.
+	 *
+	 * The file is empty (and the location is zero) after
+	 * the data has been released.
+	 *
+	 */
+	var::Data release_data();
 
 private:
+	API_ACCESS_FUNDAMENTAL(DataFile,enum growth_policy,growth_policy,growth_policy_geometric);
+	API_ACCESS_FUNDAMENTAL(DataFile,u32,growth_chunk_size,4096);
 	mutable int m_location; //offset location for seeking/reading/writing
 	OpenFlags m_open_flags;
 	mutable var::Data m_data;
+	mutable var::Vector<var::Data> m_chunk_list;
+	mutable u32 m_chunk_list_size = 0;
+	mutable u32 m_chunk_fill = 0; //bytes used in the last chunk
+
+	int grow(u32 size) const;
+	void append_chunk_list(const void * buf, u32 size) const;
+	void join_chunk_list() const;
 };
 
 class ReferenceFile : public File {
@@ -1089,6 +1185,157 @@ private:
 };
 
 
+/*! \brief Buffered File Class
+ * \details The BufferedFile class adds a read buffer
+ * to another fs::File. Reads are served from the buffer
+ * which is refilled using reads of capacity() bytes
+ * from the underlying file.
+ *
+ * This makes gets() and readline() much faster because
+ * they no longer read one byte at a time from the
+ * underlying file (which is a system call on the host
+ * or a round trip when using a link driver).
+ *
+ * read() returns the number of bytes requested unless
+ * end-of-file is reached. seek() and location() account
+ * for data that is buffered but not yet read. Writes are
+ * passed directly to the underlying file after any
+ * buffered data is discarded.
+ *
+ * ```
+ * File file;
+ * file.open("/home/log.csv", OpenFlags::read_only());
+ * BufferedFile buffered_file(file);
+ * var::String line;
+ * while( buffered_file.gets(line) ){
+ *   //process line
+ * }
+ * ```
+ *
+ * The underlying file must remain valid for the life
+ * of the BufferedFile. Closing the BufferedFile
+ * does not close the underlying file.
+ *
+ */
+class BufferedFile : public File {
+public:
+
+	/*! \details Constructs a buffered file that reads from \a file. */
+	explicit BufferedFile(
+			const File & file,
+			Size capacity = Size(SAPI_LINK_DEFAULT_PAGE_SIZE)
+			);
+
+	virtual ~BufferedFile(){
+		m_fd = -1;
+	}
+
+	/*! \details Returns an error. The underlying
+	 * file must be opened instead.
+	 */
+	int open(
+			const var::String & path,
+			const OpenFlags & flags
+			) override {
+		MCU_UNUSED_ARGUMENT(path);
+		MCU_UNUSED_ARGUMENT(flags);
+		return set_error_number_if_error(api::error_code_fs_unsupported_operation);
+	}
+
+	/*! \details Discards the buffered data. */
+	int close() override {
+		discard();
+		return 0;
+	}
+
+	int read(
+			void * buf,
+			Size nbyte
+			) const override;
+
+	int write(
+			const void * buf,
+			Size nbyte
+			) const override;
+
+	int seek(
+			int location,
+			enum whence whence = whence_set
+			) const override;
+
+	int ioctl(
+			IoRequest request,
+			IoArgument argument
+			) const override {
+		return m_file.ioctl(request, argument);
+	}
+
+	u32 size() const override { return m_file.size(); }
+
+	const char * gets(var::String & s, char term = '\n') const override;
+	int readline(char * buf, int nbyte, int timeout_msec, char terminator = '\n') const override;
+
+	using File::read;
+	using File::write;
+	using File::seek;
+	using File::gets;
+
+	/*! \details Returns the size of the read buffer. */
+	u32 capacity() const { return m_buffer.size(); }
+
+	/*! \details Returns the number of bytes that are buffered but not yet read. */
+	u32 available() const { return m_tail - m_head; }
+
+	/*! \details Discards any buffered data.
+	 *
+	 * Call this if the underlying file is accessed
+	 * directly (not through this object).
+	 *
+	 */
+	void discard() const {
+		m_head = 0;
+		m_tail = 0;
+	}
+
+	/*! \details Accesses the underlying file. */
+	const File & file() const { return m_file; }
+
+	/*! \details Returns a pointer to the available() bytes
+	 * that are buffered but not yet read.
+	 *
+	 * Parsers can scan the buffer in place and then
+	 * call advance() rather than copying with read().
+	 *
+	 */
+	const char * buffered_data() const {
+		return m_buffer.to_const_char() + m_head;
+	}
+
+	/*! \details Marks \a nbyte bytes of buffered_data() as read.
+	 *
+	 * \a nbyte must not be more than available().
+	 *
+	 */
+	void advance(u32 nbyte) const { m_head += nbyte; }
+
+	/*! \details Discards any buffered data and reads
+	 * up to capacity() bytes from the underlying file.
+	 *
+	 * @return The number of bytes that are available(), zero
+	 * at the end of the file or less than zero for an error
+	 *
+	 */
+	int fill() const;
+
+private:
+	const File & m_file;
+	mutable var::Data m_buffer;
+	mutable u32 m_head = 0; //next byte to read
+	mutable u32 m_tail = 0; //end of valid data
+
+};
+
+
 }
 
 #endif /* SAPI_FS_FILE_HPP_ */
@@ -0,0 +1,109 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_FS_MAPPEDFILE_HPP_
+#define SAPI_FS_MAPPEDFILE_HPP_
+
+#if defined __link
+
+#include "../api/FsObject.hpp"
+#include "../var/Reference.hpp"
+#include "../var/String.hpp"
+
+namespace fs {
+
+/*! \brief Mapped File Class
+ * \details The MappedFile class maps a host
+ * file in to memory (read-only) and provides
+ * access to the contents using a var::Reference.
+ *
+ * Anything that accepts a var::Reference
+ * can use the file contents without copying them
+ * in to a var::Data object first.
+ *
+ * ```
+ * MappedFile image("firmware.bin");
+ * if( image.is_mapped() ){
+ *   crypto::Sha256 hash;
+ *   hash.initialize();
+ *   hash.start();
+ *   hash << image.reference();
+ *   printf("%s\n", hash.to_string().cstring());
+ * }
+ * ```
+ *
+ * The reference is only valid while the file is mapped.
+ *
+ * This class is only available on the host. It uses mmap()
+ * on POSIX systems and file mapping objects on Windows.
+ *
+ */
+class MappedFile : public api::WorkObject {
+public:
+
+	/*! \details Constructs an object without mapping a file. */
+	MappedFile();
+
+	/*! \details Constructs an object and maps \a path.
+	 *
+	 * Use is_mapped() to see if the file was mapped.
+	 *
+	 */
+	explicit MappedFile(const var::String & path);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile & a) = delete;
+	MappedFile & operator=(const MappedFile & a) = delete;
+
+	MappedFile(MappedFile && a){
+		move_object(a);
+	}
+
+	MappedFile & operator=(MappedFile && a){
+		unmap();
+		move_object(a);
+		return *this;
+	}
+
+	/*! \details Maps the file at \a path (read-only).
+	 *
+	 * @return Zero on success or less than zero with error_number() set
+	 *
+	 * Any file that is already mapped is unmapped first.
+	 * An empty file is mapped successfully with a size() of zero.
+	 *
+	 */
+	int map(const var::String & path);
+
+	/*! \details Unmaps the file. */
+	int unmap();
+
+	/*! \details Returns true if a file is mapped. */
+	bool is_mapped() const { return m_is_mapped; }
+
+	/*! \details Returns a read-only reference to the contents of the file. */
+	const var::Reference & reference() const { return m_reference; }
+
+	/*! \details Returns the number of bytes that are mapped. */
+	u32 size() const { return m_reference.size(); }
+
+	const void * to_const_void() const { return m_reference.to_const_void(); }
+	const u8 * to_const_u8() const { return m_reference.to_const_u8(); }
+	const char * to_const_char() const { return m_reference.to_const_char(); }
+
+private:
+	var::Reference m_reference;
+	void * m_address = nullptr;
+	void * m_file_handle = nullptr;
+	void * m_mapping_handle = nullptr;
+	bool m_is_mapped = false;
+
+	void move_object(MappedFile & a);
+
+};
+
+}
+
+#endif
+
+#endif // SAPI_FS_MAPPEDFILE_HPP_
@@ -23,6 +23,7 @@ namespace sys {}
 #include "sys/Trace.hpp"
 #else
 #include "sys/Link.hpp"
+#include "sys/LinkFleet.hpp"
 #endif
 
 #include "sys/Auth.hpp"
@@ -31,6 +32,7 @@ namespace sys {}
 #include "sys/TaskManager.hpp"
 #include "sys/Cli.hpp"
 #include "sys/Printer.hpp"
+#include "sys/PrinterSink.hpp"
 #include "sys/JsonPrinter.hpp"
 #include "sys/YamlPrinter.hpp"
 #include "sys/MarkdownPrinter.hpp"
@@ -16,6 +16,7 @@
 #include "../fs/Dir.hpp"
 #include "../var/String.hpp"
 #include "../var/Vector.hpp"
+#include "../var/Array.hpp"
 #include "Appfs.hpp"
 #include "Sys.hpp"
 #include "ProgressCallback.hpp"
@@ -245,6 +246,30 @@ private:
 
 };
 
+/*! \brief Link Sync Entry Class
+ * \details The LinkSyncEntry class holds the
+ * details of one file that is tracked by
+ * Link::sync().
+ *
+ * The path is relative to the directory being synchronized.
+ *
+ */
+class LinkSyncEntry {
+public:
+	LinkSyncEntry(){}
+	explicit LinkSyncEntry(const var::String & path) : m_path(path){}
+
+	bool operator < (const LinkSyncEntry & a) const {
+		return path().compare(a.path()) < 0;
+	}
+
+private:
+	API_ACCESS_COMPOUND(LinkSyncEntry, var::String, path);
+	API_ACCESS_COMPOUND(LinkSyncEntry, var::String, digest);
+	API_ACCESS_FUNDAMENTAL(LinkSyncEntry, u32, size, 0);
+	API_ACCESS_FUNDAMENTAL(LinkSyncEntry, u32, mtime, 0);
+};
+
 /*! \brief Link for Controlling Stratify OS remotely
  * \details This class is used to access devices
  * running Stratify OS from a remote platform (desktop/mobile/web).
@@ -516,6 +541,67 @@ public:
 					);
 	}
 
+	/*! \brief Sync Options
+	 * \details The SyncOptions class specifies how sync()
+	 * handles files on the device.
+	 *
+	 * - `remove_stale` deletes device files that are not in the host directory
+	 * - `verify_device` hashes device files that have changed since the last sync
+	 *   rather than copying them unconditionally
+	 *
+	 */
+	class SyncOptions {
+		API_ACCESS_BOOL(SyncOptions,remove_stale,false);
+		API_ACCESS_BOOL(SyncOptions,verify_device,false);
+		API_ACCESS_FUNDAMENTAL(SyncOptions,u16,permissions,0666);
+		API_ACCESS_FUNDAMENTAL(SyncOptions,const ProgressCallback*,progress_callback,nullptr);
+	};
+
+	/*! \details Synchronizes a directory on the device with
+	 * a directory on the host.
+	 *
+	 * @param host_directory The source directory on the host
+	 * @param device_directory The destination directory on the device
+	 * @param options Options for the sync
+	 * @return The number of files copied or less than zero if there was an error
+	 *
+	 * Only new files and files whose size or SHA256 digest differ are copied.
+	 * The digests of the files on the device are stored in
+	 * a manifest (see sync_manifest_name()) in \a device_directory. The manifest
+	 * is read with a single request. Each entry is trusted as long as
+	 * the size and modification time of the device file still match it, so
+	 * unchanged files are never read back from the device. The device
+	 * files are still stat'd one at a time because the link protocol has no
+	 * request that returns the attributes of several files.
+	 *
+	 * A copied file is only recorded in the manifest if its size on the
+	 * device matches the host. Otherwise the remaining files are still
+	 * copied and sync() returns an error.
+	 *
+	 * The progress callback is updated with the number of files processed.
+	 *
+	 * ```
+	 * Link link;
+	 * //connect to the device
+	 * int count = link.sync(
+	 *   Link::SourcePath("assets"),
+	 *   Link::DestinationPath("/home/assets"),
+	 *   Link::SyncOptions().set_remove_stale()
+	 *   );
+	 * ```
+	 *
+	 */
+	int sync(
+			SourcePath host_directory,
+			DestinationPath device_directory,
+			const SyncOptions & options = SyncOptions()
+			);
+
+	/*! \details Returns the name of the manifest file that sync()
+	 * keeps in the device directory.
+	 */
+	static const char * sync_manifest_name(){ return ".sync_manifest"; }
+
 	/*! \details Formats the filesystem on the device.
 		*
 		* \return Zero on success
@@ -822,6 +908,74 @@ public:
 		return *this;
 	}
 
+	/*! \details Sets whether update_os() verifies the installed
+	 * image using SHA256 digests rather than comparing each
+	 * block that is read back.
+	 *
+	 * The digest of the image is calculated while it is written. The
+	 * flashed range is then read back in large batches
+	 * and hashed (see calculate_flash_digest()) so only
+	 * one comparison is made.
+	 *
+	 */
+	Link& set_digest_verify(bool value = true){
+		m_is_digest_verify = value;
+		return *this;
+	}
+
+	/*! \details Returns true if update_os() will verify using digests. */
+	bool is_digest_verify() const { return m_is_digest_verify; }
+
+	/*! \details Calculates the SHA256 digest of a range of flash memory.
+	 *
+	 * @param address The starting address of the range
+	 * @param size The number of bytes in the range
+	 * @param digest The destination for the digest
+	 * @return Zero on success
+	 *
+	 * The device must be connected to the bootloader. The
+	 * bootloader protocol does not provide a digest request so the range
+	 * is read back using pages of flash_digest_page_size() bytes
+	 * and hashed on the host.
+	 *
+	 */
+	int calculate_flash_digest(
+			u32 address,
+			u32 size,
+			var::Array<u8, 32> & digest
+			);
+
+	/*! \details Returns the number of bytes read per
+	 * request when calculating a flash digest.
+	 */
+	static u32 flash_digest_page_size(){ return 16*1024; }
+
+	/*! \details Sets whether update_os() and install_app() only
+	 * write what has changed on the device.
+	 *
+	 * - update_os() skips the erase and install if the flashed OS
+	 *   already matches the image (the bootloader can only erase
+	 *   the entire OS so a partial update is not possible); flash is
+	 *   read back one page at a time and the comparison stops at the
+	 *   first page that differs
+	 * - install_app() to a filesystem (not `/app`) compares page digests
+	 *   of the new image with the existing file and rewrites only the pages
+	 *   that differ; the first page is written last
+	 *
+	 */
+	Link& set_delta_update(bool value = true){
+		m_is_delta_update = value;
+		return *this;
+	}
+
+	/*! \details Returns true if delta updates are enabled. */
+	bool is_delta_update() const { return m_is_delta_update; }
+
+	/*! \details Returns the page size used to compare images
+	 * for delta updates.
+	 */
+	static u32 delta_page_size(){ return 4096; }
+
 	Link& set_progress(int p){ m_progress = p; return *this; }
 	Link& set_progress_max(int p){ m_progress_max = p; return *this; }
 
@@ -896,6 +1050,8 @@ private:
 	volatile int m_lock = 0;
 	bool m_is_bootloader = false;
 	bool m_is_legacy = false;
+	bool m_is_digest_verify = false;
+	bool m_is_delta_update = false;
 
 	LinkInfo m_link_info;
 	bootloader_attr_t m_bootloader_attributes = {0};
@@ -918,6 +1074,34 @@ private:
 								 Printer & progress_printer
 								 );
 
+	int is_os_installed(
+			const fs::File & image,
+			HardwareId image_id
+			);
+
+	int read_sync_device_list(
+			const var::String & device_directory,
+			const var::String & relative_path,
+			var::Vector<LinkSyncEntry> & list,
+			var::Vector<var::String> & directory_list
+			);
+
+	int read_sync_manifest(
+			const var::String & device_directory,
+			var::Vector<LinkSyncEntry> & list
+			);
+
+	int write_sync_manifest(
+			const var::String & device_directory,
+			const var::Vector<LinkSyncEntry> & list
+			);
+
+	int install_app_delta(
+			const fs::File & application_image,
+			const var::String & path,
+			const ProgressCallback * progress_callback
+			);
+
 	int check_error(int err);
 	void reset_progress();
 
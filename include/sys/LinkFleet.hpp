@@ -0,0 +1,189 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_SYS_LINKFLEET_HPP_
+#define SAPI_SYS_LINKFLEET_HPP_
+
+#if defined __link
+
+#include <atomic>
+
+#include "../api/SysObject.hpp"
+#include "../var/Vector.hpp"
+#include "Link.hpp"
+#include "Mutex.hpp"
+#include "ProgressCallback.hpp"
+
+namespace sys {
+
+/*! \brief Link Fleet Device Class
+ * \details The LinkFleetDevice class holds
+ * the state of one device while a LinkFleet
+ * job is executing.
+ *
+ * The progress values are updated by the worker thread
+ * that is driving the device so they can be
+ * polled from another thread to show the progress
+ * of each device.
+ *
+ */
+class LinkFleetDevice {
+public:
+
+	LinkFleetDevice(){}
+	explicit LinkFleetDevice(const LinkInfo & info) : m_info(info){}
+
+	LinkFleetDevice(const LinkFleetDevice & a){ copy(a); }
+	LinkFleetDevice& operator=(const LinkFleetDevice & a){
+		copy(a);
+		return *this;
+	}
+
+	/*! \details Returns true if the last job completed successfully. */
+	bool is_success() const { return m_result >= 0; }
+
+	/*! \details Returns the achieved throughput in bytes per second. */
+	u32 rate() const {
+		if( m_microseconds == 0 ){ return 0; }
+		return static_cast<u32>(
+					(static_cast<u64>(m_size) * 1000000UL) / m_microseconds
+					);
+	}
+
+	int progress() const { return m_progress.load(); }
+	int progress_max() const { return m_progress_max.load(); }
+
+	/*! \cond */
+	void set_progress(int value, int total){
+		m_progress_max.store(total);
+		m_progress.store(value);
+	}
+	/*! \endcond */
+
+private:
+	API_ACCESS_COMPOUND(LinkFleetDevice, LinkInfo, info);
+	API_ACCESS_COMPOUND(LinkFleetDevice, var::String, error_message);
+	API_ACCESS_FUNDAMENTAL(LinkFleetDevice, int, result, 0);
+	API_ACCESS_FUNDAMENTAL(LinkFleetDevice, u32, size, 0);
+	API_ACCESS_FUNDAMENTAL(LinkFleetDevice, u32, microseconds, 0);
+	std::atomic<int> m_progress{0};
+	std::atomic<int> m_progress_max{0};
+
+	void copy(const LinkFleetDevice & a){
+		m_info = a.m_info;
+		m_error_message = a.m_error_message;
+		m_result = a.m_result;
+		m_size = a.m_size;
+		m_microseconds = a.m_microseconds;
+		m_progress.store(a.m_progress.load());
+		m_progress_max.store(a.m_progress_max.load());
+	}
+};
+
+/*! \brief Link Fleet Class
+ * \details The LinkFleet class drives many devices
+ * at the same time. One sys::Link is connected per device
+ * and jobs are executed by a pool of worker threads.
+ *
+ * A failure on one device is recorded in that device's
+ * LinkFleetDevice entry and does not affect the other devices.
+ *
+ * ```
+ * LinkFleet fleet(
+ *   LinkFleet::Options().set_thread_count(8)
+ *   );
+ *
+ * fleet.discover();
+ *
+ * int failures = fleet.execute(
+ *   LinkFleet::Job()
+ *     .set_type(LinkFleet::job_type_copy)
+ *     .set_source_path("assets/image.bin")
+ *     .set_destination_path("/home/image.bin")
+ *   );
+ *
+ * printf("%d devices failed at %ld bytes/second\n", failures, fleet.rate());
+ * ```
+ *
+ */
+class LinkFleet : public api::WorkObject {
+public:
+
+	enum job_type {
+		job_type_copy /*! Copy a host file to each device */,
+		job_type_install_app /*! Install an application on each device */,
+		job_type_update_os /*! Update the OS on each device (must be connected to the bootloader) */
+	};
+
+	class Options {
+		API_ACCESS_FUNDAMENTAL(Options,u32,thread_count,4);
+		API_ACCESS_FUNDAMENTAL(Options,u32,stack_size,65536);
+		/*! \details The driver used for each link (nullptr uses the default driver). */
+		API_ACCESS_FUNDAMENTAL(Options,link_transport_mdriver_t*,driver,nullptr);
+	};
+
+	class Job {
+		API_ACCESS_FUNDAMENTAL(Job,enum job_type,type,job_type_copy);
+		API_ACCESS_COMPOUND(Job,var::String,source_path);
+		API_ACCESS_COMPOUND(Job,var::String,destination_path);
+		API_ACCESS_COMPOUND(Job,var::String,application_name);
+		API_ACCESS_FUNDAMENTAL(Job,u16,permissions,0666);
+		API_ACCESS_BOOL(Job,verify,true);
+	};
+
+	explicit LinkFleet(const Options & options = Options());
+
+	/*! \details Finds all the devices that are attached to the host.
+	 *
+	 * @return The number of devices that were found
+	 *
+	 */
+	int discover();
+
+	/*! \details Sets the devices to use rather than calling discover(). */
+	LinkFleet & set_info_list(const var::Vector<LinkInfo> & info_list);
+
+	/*! \details Executes the job on all devices.
+	 *
+	 * @return The number of devices that failed or less than zero if
+	 * the job couldn't be started
+	 *
+	 * This method blocks until the job has completed on every device.
+	 *
+	 */
+	int execute(const Job & job);
+
+	/*! \details Accesses the devices and the results of the last job. */
+	const var::Vector<LinkFleetDevice> & device_list() const { return m_device_list; }
+
+	/*! \details Returns the total number of bytes transferred by the last job. */
+	u32 size() const;
+
+	/*! \details Returns the aggregate throughput (bytes per second) of the last job. */
+	u32 rate() const {
+		if( m_microseconds == 0 ){ return 0; }
+		return static_cast<u32>(
+					(static_cast<u64>(size()) * 1000000UL) / m_microseconds
+					);
+	}
+
+private:
+	Options m_options;
+	var::Vector<LinkFleetDevice> m_device_list;
+	u32 m_microseconds = 0;
+
+	//shared with the worker threads while execute() is running
+	Mutex m_mutex;
+	const Job * m_job = nullptr;
+	u32 m_next_device = 0;
+
+	static void * execute_worker(void * args);
+	void * execute_worker();
+	int execute_device(Link & link, LinkFleetDevice & device);
+
+};
+
+}
+
+#endif
+
+#endif // SAPI_SYS_LINKFLEET_HPP_
@@ -17,6 +17,8 @@ class Result;
 
 namespace sys {
 
+class PrinterSink;
+
 struct PrinterFlags {
 	/*! \details Number printing flags. */
 	enum print_flags {
@@ -125,12 +127,77 @@ private:
  * p.open_object("System Information") << SysInfo::get() << p.close();
  * ```
  *
+ * The output is written to the sink() (the standard output
+ * unless set_sink() is used). Output to the standard output is
+ * passed straight to stdio, which does its own buffering, so it
+ * stays in order with printf() and isn't lost when exit() is called.
+ *
+ * Output to other sinks is collected in a buffer. In
+ * flush_mode_line, the buffer is flushed at the end of each line.
+ * In flush_mode_full, it is only flushed when it is full, when
+ * flush() is called or when the printer is destroyed. Link builds
+ * use flush_mode_full when the standard output is not a terminal
+ * (such as when the output is piped to another program).
+ *
+ * warning(), error() and fatal() always flush. Call flush()
+ * before exit() if the printer uses a sink other than the
+ * standard output.
+ *
  */
 class Printer : public api::WorkObject, public PrinterFlags {
 public:
+
+	enum flush_mode {
+		flush_mode_line /*! Flush the output at the end of each line */,
+		flush_mode_full /*! Flush the output when the buffer is full or flush() is called */
+	};
+
+	enum {
+		default_buffer_size /*! Default size of the output buffer */ = 512
+	};
+
 	Printer();
 	~Printer();
 
+	/*! \details Sets where the output is written (null for the standard output).
+	 *
+	 * Any buffered output is flushed to the previous sink. The
+	 * sink must remain valid until the printer is destroyed or
+	 * another sink is set.
+	 *
+	 */
+	Printer & set_sink(PrinterSink * sink);
+
+	/*! \details Returns the sink that receives the output. */
+	PrinterSink * sink() const;
+
+	Printer & set_flush_mode(enum flush_mode value){
+		m_flush_mode = value;
+		return *this;
+	}
+
+	enum flush_mode flush_mode() const { return m_flush_mode; }
+
+	/*! \details Sets the number of bytes that are buffered before
+	 * the output is written to the sink.
+	 *
+	 * The buffer isn't used if the sink does its own
+	 * buffering (such as the standard output).
+	 *
+	 */
+	Printer & set_buffer_size(u32 value){
+		m_buffer_size = value;
+		return *this;
+	}
+
+	u32 buffer_size() const { return m_buffer_size; }
+
+	/*! \details Writes the buffered output to the sink and flushes the sink. */
+	Printer & flush();
+
+	/*! \details Writes \a size bytes of \a data to the output (no formatting is applied). */
+	Printer & write(const char * data, u32 size);
+
 
 	static u32 color_code(const var::String & color);
 
@@ -346,6 +413,13 @@ private:
 	bool m_is_bash;
 #endif
 
+	PrinterSink * m_sink = nullptr;
+	var::String m_buffer;
+	u32 m_buffer_size = default_buffer_size;
+	enum flush_mode m_flush_mode = flush_mode_line;
+
+	void write_buffer();
+
 };
 
 class NullPrinter : public Printer {
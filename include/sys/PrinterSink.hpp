@@ -0,0 +1,113 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_SYS_PRINTERSINK_HPP_
+#define SAPI_SYS_PRINTERSINK_HPP_
+
+#include "../fs/File.hpp"
+#include "../var/Data.hpp"
+
+namespace sys {
+
+/*! \brief Printer Sink Class
+ * \details A PrinterSink is where a Printer sends its
+ * output. The Printer collects the output in a buffer and
+ * passes it to the sink in large blocks unless the sink
+ * does its own buffering (see is_buffered()).
+ *
+ * Inherit this class to send the output somewhere else.
+ *
+ */
+class PrinterSink {
+public:
+	virtual ~PrinterSink(){}
+
+	/*! \details Writes \a size bytes to the sink.
+	 *
+	 * @return The number of bytes written or less than zero for an error
+	 *
+	 */
+	virtual int write(const char * data, u32 size) = 0;
+
+	/*! \details Pushes any data held by the sink to its destination. */
+	virtual int flush(){ return 0; }
+
+	/*! \details Returns true if the sink buffers the data itself.
+	 *
+	 * The Printer passes each write straight to a sink that
+	 * is buffered rather than collecting it first.
+	 *
+	 */
+	virtual bool is_buffered() const { return false; }
+};
+
+/*! \brief Printer Standard Output Sink Class
+ * \details This sink writes to the standard output. It
+ * is used by a Printer that doesn't have another sink.
+ *
+ * The output goes straight to stdio so it stays in order
+ * with printf() and is flushed by exit().
+ *
+ */
+class PrinterStandardOutputSink : public PrinterSink {
+public:
+	int write(const char * data, u32 size) override;
+	int flush() override;
+	bool is_buffered() const override { return true; }
+
+	/*! \details Returns the sink shared by all printers. */
+	static PrinterStandardOutputSink & instance();
+};
+
+/*! \brief Printer File Sink Class
+ * \details This sink writes to an fs::File.
+ *
+ * ```
+ * //md2code:main
+ * File output;
+ * output.create("/home/tasks.json", File::IsOverwrite(true));
+ * PrinterFileSink sink(output);
+ * JsonPrinter printer;
+ * printer.set_sink(&sink);
+ * printer.open_object("tasks") << TaskManager() << printer.close();
+ * printer.flush();
+ * ```
+ *
+ */
+class PrinterFileSink : public PrinterSink {
+public:
+	explicit PrinterFileSink(const fs::File & file) : m_file(file){}
+
+	int write(const char * data, u32 size) override {
+		return m_file.write(data, fs::File::Size(size));
+	}
+
+private:
+	const fs::File & m_file;
+};
+
+/*! \brief Printer Data Sink Class
+ * \details This sink appends the output to a var::Data object.
+ *
+ */
+class PrinterDataSink : public PrinterSink {
+public:
+	explicit PrinterDataSink(var::Data & data) : m_data(data){}
+
+	int write(const char * data, u32 size) override {
+		m_data.append(
+					var::Reference(
+						var::Reference::ReadOnlyBuffer(data),
+						var::Reference::Size(size)
+						)
+					);
+		return size;
+	}
+
+	const var::Data & data() const { return m_data; }
+
+private:
+	var::Data & m_data;
+};
+
+}
+
+#endif // SAPI_SYS_PRINTERSINK_HPP_
@@ -62,11 +62,33 @@ public:
 	 */
 	bool update(int value, int total) const;
 
+	/*! \details Executes the callback and records the transfer rate.
+	 *
+	 * @param value The value of the progress of the operation
+	 * @param total The total possible progress for the operation
+	 * @param rate The achieved rate in bytes per second
+	 * @return true to abort the operation or false to continue as normal
+	 *
+	 * The rate is available to the callback using rate().
+	 *
+	 */
+	bool update(int value, int total, u32 rate) const {
+		m_rate = rate;
+		return update(value, total);
+	}
+
+	/*! \details Returns the most recent rate (bytes per second)
+	 * reported by the operation or zero if the operation doesn't
+	 * report a rate.
+	 */
+	u32 rate() const { return m_rate; }
+
 	static int update_function(const void * context, int value, int total);
 
 private:
 	API_AF(ProgressCallback,callback_t,callback,nullptr);
 	API_AF(ProgressCallback,void*,context,nullptr);
+	mutable u32 m_rate = 0;
 
 };
 
@@ -15,14 +15,19 @@ namespace var {}
 #include "var/Flags.hpp"
 #include "var/Item.hpp"
 #include "var/Ring.hpp"
+#include "var/SpscRing.hpp"
 #include "var/LinkedList.hpp"
 #include "var/Deque.hpp"
 #include "var/Queue.hpp"
 #include "var/Stack.hpp"
 #include "var/Json.hpp"
+#include "var/JsonReader.hpp"
+#include "var/JsonArena.hpp"
 #include "var/ConstString.hpp"
 #include "var/VersionString.hpp"
 #include "var/String.hpp"
+#include "var/StringView.hpp"
+#include "var/CharacterSet.hpp"
 #include "var/Tokenizer.hpp"
 #include "var/Vector.hpp"
 #include "var/Array.hpp"
@@ -0,0 +1,111 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_VAR_CHARACTERSET_HPP_
+#define SAPI_VAR_CHARACTERSET_HPP_
+
+#include "StringView.hpp"
+
+namespace var {
+
+/*! \brief Character Set Class
+ * \details The CharacterSet class holds a set of characters
+ * (such as delimeters or quotes) compiled in to a 256-bit
+ * table so that membership is checked with a single lookup.
+ *
+ * The find() method returns the position of the next character
+ * in the input that belongs to the set. On x86 host builds,
+ * find() compares 16 bytes (SSE2) or 32 bytes (AVX2) at a time
+ * for sets of up to maximum_vector_count characters. Other builds
+ * (and larger sets) use the portable table lookup.
+ *
+ * ```
+ * //md2code:main
+ * CharacterSet line_end("\r\n");
+ * String line = "key: value\r\n";
+ * size_t end = line_end.find(line);
+ * printf("line is %d characters\n", end);
+ * ```
+ *
+ * var::Tokenizer, fmt::Csv, String::split() and
+ * inet::HttpHeaderPair use this class to scan their inputs.
+ *
+ */
+class CharacterSet {
+public:
+
+	enum {
+		maximum_vector_count /*! Largest set that is scanned using vector instructions */ = 16
+	};
+
+	enum npos {
+		npos /*! Defines an invalid position */ = StringView::npos
+	};
+
+	/*! \details Constructs an empty set. */
+	CharacterSet(){ clear(); }
+
+	/*! \details Constructs a set containing each character in \a characters. */
+	explicit CharacterSet(const StringView & characters){
+		clear();
+		add(characters);
+	}
+
+	/*! \details Adds \a c to the set. */
+	CharacterSet & add(char c);
+
+	/*! \details Adds each character in \a characters to the set. */
+	CharacterSet & add(const StringView & characters){
+		for(char c: characters){ add(c); }
+		return *this;
+	}
+
+	/*! \details Adds each character in \a a to the set. */
+	CharacterSet & add(const CharacterSet & a);
+
+	/*! \details Removes all characters from the set. */
+	CharacterSet & clear();
+
+	/*! \details Returns true if \a c is in the set. */
+	bool contains(char c) const {
+		const u8 value = static_cast<u8>(c);
+		return (m_table[value >> 5] & (1UL << (value & 0x1f))) != 0;
+	}
+
+	/*! \details Returns the number of characters in the set. */
+	u32 count() const { return m_count; }
+
+	bool is_empty() const { return m_count == 0; }
+
+	/*! \details Returns the position of the first character
+	 * in \a input (starting at \a position) that belongs to the set
+	 * or npos if there isn't one.
+	 *
+	 */
+	size_t find(
+			const StringView & input,
+			size_t position = 0
+			) const;
+
+	/*! \details Returns the position of the first character
+	 * in \a input (starting at \a position) that does not belong
+	 * to the set or npos if there isn't one.
+	 *
+	 */
+	size_t find_not(
+			const StringView & input,
+			size_t position = 0
+			) const;
+
+private:
+	/*! \cond */
+	u32 m_table[256/32];
+	char m_list[maximum_vector_count];
+	u32 m_count;
+
+	size_t find_portable(const char * data, size_t length, size_t position) const;
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_VAR_CHARACTERSET_HPP_
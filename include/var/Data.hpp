@@ -386,6 +386,8 @@ public:
 
 	void reserve(size_t size){
 		m_data.reserve(size);
+		//reserve() can reallocate the vector
+		update_reference();
 	}
 
 
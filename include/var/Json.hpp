@@ -7,6 +7,7 @@
 #include "../var/Vector.hpp"
 #include "../var/String.hpp"
 #include "../fs/File.hpp"
+#include "JsonArena.hpp"
 #include "../sys/requests.h"
 
 namespace var {
@@ -270,6 +271,7 @@ private:
 	friend class JsonString;
 	friend class JsonNull;
 	friend class JsonKeyValue;
+	friend class JsonReaderHandler;
 	json_t * m_value;
 	static JsonApi m_api;
 
@@ -601,6 +603,30 @@ public:
 		set_flags(o_flags);
 	}
 
+	~JsonDocument();
+
+	//a copy does not share the arena
+	JsonDocument(const JsonDocument & a) : m_flags(a.m_flags), m_error(a.m_error){}
+	JsonDocument & operator=(const JsonDocument & a){
+		m_flags = a.m_flags;
+		m_error = a.m_error;
+		return *this;
+	}
+
+	/*! \details Loads values in to an arena that is owned by this document.
+	 *
+	 * @param block_size The size of each block of the arena
+	 *
+	 * Values that are loaded (or built inside a JsonArena::Scope
+	 * using arena()) are freed all at once when the document is
+	 * destroyed. They must not be used after that.
+	 *
+	 */
+	JsonDocument & enable_arena(u32 block_size = JsonArena::default_block_size);
+
+	/*! \details Returns the arena or null if enable_arena() has not been called. */
+	JsonArena * arena() const { return m_arena; }
+
 	JsonDocument & set_options(u32 o_option){ m_flags = o_option; return *this; }
 	u32 options() const { return m_flags; }
 
@@ -629,9 +655,13 @@ public:
 	using XmlFilePath = arg::Argument<const String &, struct JsonDocumentXmlFilePathTag>;
 
 	/*!
-		* \details Loads a JSON value from a data object
-		* \param data A reference to the data object containing the JSON
-		* \return
+		* \details Loads a JSON value from XML
+		* \param xml The XML text (not modified)
+		* \return The JSON value (invalid if the XML can't be parsed, see error())
+		*
+		* The XML is converted directly to JSON values. Elements
+		* become keys, attributes become "@name" keys, text in an element
+		* with attributes becomes "#text" and repeated elements become arrays.
 		*/
 	JsonValue load(
 			XmlString xml
@@ -694,9 +724,14 @@ private:
 
 	u32 m_flags;
 	JsonError m_error;
+	JsonArena * m_arena = nullptr;
 
 	static size_t load_file_data(void * buffer, size_t buflen, void *data);
 
+#if defined __link
+	JsonValue load_xml(char * xml);
+#endif
+
 };
 
 }
@@ -0,0 +1,143 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_VAR_JSONARENA_HPP_
+#define SAPI_VAR_JSONARENA_HPP_
+
+#include "../api/WorkObject.hpp"
+#include "Data.hpp"
+#include "Vector.hpp"
+
+namespace var {
+
+/*! \brief Json Arena Class
+ * \details A JsonArena provides memory for the JSON values
+ * (nodes and strings) that are created while the arena is active.
+ *
+ * Memory is handed out from large var::Data blocks by bumping a
+ * pointer. Freeing a value that is in the arena does nothing. All
+ * of the memory is released at once when the arena is destroyed (or
+ * reset()). This makes creating and destroying large documents
+ * much faster than allocating each node from the heap.
+ *
+ * Use JsonDocument::enable_arena() to have a document load values
+ * in to its own arena. Use a JsonArena::Scope to build values
+ * in the arena.
+ *
+ * ```
+ * //md2code:main
+ * JsonDocument document;
+ * document.enable_arena();
+ * {
+ *   JsonObject config = document.load(JsonDocument::FilePath("/home/config.json"));
+ *   //use config
+ * } //config must be destroyed before document
+ * printf("used %ld bytes\n", document.arena()->peak_size());
+ * ```
+ *
+ * Values that are created in the arena must be destroyed
+ * before the arena is destroyed or reset().
+ *
+ * \note The arena uses the jansson allocation functions, which are
+ * shared by the whole process. On Stratify OS, the jansson API is shared
+ * by all applications, so the functions are not replaced and arena
+ * allocations are only used on link builds (values come from the heap
+ * otherwise).
+ *
+ */
+class JsonArena : public api::WorkObject {
+public:
+
+	enum {
+		default_block_size /*! Default size of each block of the arena */ = 64*1024
+	};
+
+	/*! \brief Json Arena Scope Class
+	 * \details Values created while a Scope exists
+	 * (in the same thread) are allocated from the arena.
+	 *
+	 */
+	class Scope {
+	public:
+		/*! \details Activates \a arena (nothing happens if \a arena is null). */
+		explicit Scope(JsonArena * arena);
+		~Scope();
+
+		Scope(const Scope & a) = delete;
+		Scope & operator=(const Scope & a) = delete;
+
+	private:
+		JsonArena * m_previous;
+	};
+
+	/*! \details Constructs a new arena.
+	 *
+	 * @param block_size The size of each block allocated from the heap
+	 *
+	 */
+	explicit JsonArena(u32 block_size = default_block_size);
+	~JsonArena();
+
+	JsonArena(const JsonArena & a) = delete;
+	JsonArena & operator=(const JsonArena & a) = delete;
+
+	/*! \details Allocates \a size bytes from the arena. */
+	void * allocate(size_t size);
+
+	/*! \details Returns true if \a pointer is in the arena. */
+	bool is_in_arena(const void * pointer) const;
+
+	/*! \details Returns true if \a pointer is in any arena.
+	 *
+	 * No lock is taken. The check searches a copy of the block list
+	 * that is replaced (not modified) when an arena adds or
+	 * releases a block.
+	 *
+	 */
+	static bool is_arena_memory(const void * pointer);
+
+	/*! \details Starts allocating from the beginning of the arena.
+	 *
+	 * The blocks are kept and reused so a document that is loaded
+	 * and discarded repeatedly doesn't allocate any heap memory
+	 * after the first time.
+	 *
+	 * All the values that were created in the arena must already
+	 * be destroyed.
+	 *
+	 */
+	void reset();
+
+	/*! \details Returns the number of bytes allocated from the arena. */
+	u32 size() const { return m_size; }
+
+	/*! \details Returns the most bytes that have been allocated between resets. */
+	u32 peak_size() const { return m_peak_size > m_size ? m_peak_size : m_size; }
+
+	/*! \details Returns the total size of the blocks. */
+	u32 capacity() const { return m_capacity; }
+
+	u32 block_count() const { return m_block_list.count(); }
+	u32 allocation_count() const { return m_allocation_count; }
+	u32 block_size() const { return m_block_size; }
+
+	/*! \details Returns the arena that is active in this thread (or null). */
+	static JsonArena * active();
+
+private:
+	/*! \cond */
+	//blocks are not moved once allocated so pointers in to them remain valid
+	var::Vector<var::Data*> m_block_list;
+	u32 m_block_size;
+	u32 m_block_index = 0;
+	u32 m_block_offset = 0;
+	u32 m_size = 0;
+	u32 m_peak_size = 0;
+	u32 m_capacity = 0;
+	u32 m_allocation_count = 0;
+
+	var::Data * add_block(size_t size);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_VAR_JSONARENA_HPP_
@@ -0,0 +1,187 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+#ifndef SAPI_VAR_JSONREADER_HPP_
+#define SAPI_VAR_JSONREADER_HPP_
+
+#include <functional>
+#include "Json.hpp"
+#include "StringView.hpp"
+
+namespace var {
+
+class JsonReaderHandler;
+
+/*! \brief Json Reader Class
+ * \details The JsonReader class parses JSON from an fs::File
+ * (including a fs::DataFile, a sys::Link backed file or an
+ * inet::Socket) without loading the whole document in to memory.
+ *
+ * The file is read in blocks of Options::buffer_size() bytes and each
+ * value is reported as an Event while it is parsed. Use read() with a
+ * list of paths to build (as a JsonValue) only the parts of the
+ * document that are needed.
+ *
+ * Paths use JSON pointer syntax (RFC 6901) such as "/samples/0/time".
+ * A path segment of "*" matches any key or array index.
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * #include <sapi/fs.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * File telemetry;
+ * telemetry.open("/home/telemetry.json", OpenFlags::read_only());
+ *
+ * //only each element of the samples array is built as a JsonValue
+ * //("/samples/" "*" is the path "/samples/" followed by the wildcard)
+ * JsonReader(telemetry).read(
+ *   StringList({"/samples/" "*"}),
+ *   [](const String & path, const JsonValue & value){
+ *     printf("%s time is %f\n", path.cstring(), value.to_object().at("time").to_float());
+ *     return true; //keep reading
+ *   });
+ * ```
+ *
+ */
+class JsonReader : public api::WorkObject {
+public:
+
+	class Options {
+	public:
+		Options(){}
+	private:
+		/*! \cond */
+		API_ACCESS_FUNDAMENTAL(Options,u32,buffer_size,512);
+		API_ACCESS_BOOL(Options,allow_comments,false);
+		API_ACCESS_BOOL(Options,allow_trailing_commas,false);
+		/*! \endcond */
+	};
+
+	enum event_type {
+		event_start_object,
+		event_end_object,
+		event_start_array,
+		event_end_array,
+		event_string,
+		event_integer,
+		event_real,
+		event_true,
+		event_false,
+		event_null
+	};
+
+	/*! \brief Json Reader Event Class
+	 * \details An Event is passed to the callback for
+	 * each value that is parsed. The path, key and string
+	 * only remain valid while the callback is executing.
+	 *
+	 */
+	class Event {
+	public:
+		enum event_type type() const { return m_type; }
+
+		/*! \details Returns the JSON pointer to the value (empty for the root). */
+		const String & path() const { return *m_path; }
+
+		/*! \details Returns the key of the value if its parent is an object. */
+		const StringView & key() const { return m_key; }
+
+		/*! \details Returns the array index if the parent is an array. */
+		u32 index() const { return m_index; }
+
+		/*! \details Returns the number of containers above the value. */
+		u32 depth() const { return m_depth; }
+
+		/*! \details Returns the string value (event_string only). */
+		const StringView & string() const { return m_string; }
+		s64 integer() const { return m_integer; }
+		double real() const { return m_real; }
+
+		bool is_start() const {
+			return (m_type == event_start_object) || (m_type == event_start_array);
+		}
+
+		bool is_end() const {
+			return (m_type == event_end_object) || (m_type == event_end_array);
+		}
+
+	private:
+		friend class JsonReaderHandler;
+		enum event_type m_type = event_null;
+		const String * m_path = nullptr;
+		StringView m_key;
+		StringView m_string;
+		s64 m_integer = 0;
+		double m_real = 0.0;
+		u32 m_index = 0;
+		u32 m_depth = 0;
+	};
+
+	/*! \details Return true to keep reading or false to stop. */
+	using EventCallback = std::function<bool(const Event & event)>;
+
+	/*! \details Return true to keep reading or false to stop. */
+	using ValueCallback = std::function<bool(const String & path, const JsonValue & value)>;
+
+	explicit JsonReader(
+			const fs::File & file,
+			const Options & options = Options()
+			) : m_file(file), m_options(options){}
+
+	/*! \details Reads the file from the current location
+	 * and calls \a callback for each event.
+	 *
+	 * @return Zero on success (including when \a callback stops the
+	 * reader) or less than zero if the JSON is not valid
+	 *
+	 */
+	int read(EventCallback callback);
+
+	/*! \details Reads the file from the current location and calls
+	 * \a callback with each value whose path matches one of the paths
+	 * in \a path_list.
+	 *
+	 * Only matching values are built as JsonValue objects. Each
+	 * one is freed when \a callback returns.
+	 *
+	 * @return Zero on success or less than zero if the JSON is not valid
+	 *
+	 */
+	int read(
+			const StringList & path_list,
+			ValueCallback callback
+			);
+
+	/*! \details Returns true if \a path matches \a pattern. */
+	static bool is_path_match(
+			const StringView & pattern,
+			const StringView & path
+			);
+
+	/*! \details Returns the position in the input where the error was detected. */
+	u32 error_offset() const { return m_error_offset; }
+
+	/*! \details Returns a description of the error. */
+	const String & error_message() const { return m_error_message; }
+
+	/*! \details Returns the number of bytes read from the file. */
+	u32 bytes_read() const { return m_bytes_read; }
+
+private:
+	/*! \cond */
+	friend class JsonReaderHandler;
+	const fs::File & m_file;
+	Options m_options;
+	u32 m_error_offset = 0;
+	u32 m_bytes_read = 0;
+	String m_error_message;
+
+	int read_with_handler(JsonReaderHandler & handler);
+	/*! \endcond */
+};
+
+}
+
+#endif // SAPI_VAR_JSONREADER_HPP_
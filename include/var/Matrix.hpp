@@ -1,78 +1,403 @@
+
 #ifndef SAPI_VAR_MATRIX_HPP_
 #define SAPI_VAR_MATRIX_HPP_
 
+#include <functional>
+#include <iterator>
+#include <type_traits>
 #include "../sys/Printer.hpp"
 #include "Vector.hpp"
 
 namespace var {
 
-template <typename T> class Matrix : public var::Vector<var::Vector<T>> {
+/*! \brief Matrix View Class
+ * \details A MatrixView refers to \a count elements of
+ * a Matrix that are \a stride elements apart. A row of a matrix
+ * has a stride of one and a column has a stride of
+ * Matrix::column_count().
+ *
+ * The view does not own the elements. It is only valid
+ * until the matrix is resized or more rows are appended (appending
+ * a view of the same matrix is fine).
+ *
+ */
+template <typename T> class MatrixView {
+public:
+
+	using value_type = typename std::remove_const<T>::type;
+
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename std::remove_const<T>::type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		Iterator(T * value, u32 stride) : m_value(value), m_stride(stride){}
+
+		T & operator*() const { return *m_value; }
+		T * operator->() const { return m_value; }
+
+		Iterator & operator++(){
+			m_value += m_stride;
+			return *this;
+		}
+
+		Iterator operator++(int){
+			Iterator result = *this;
+			m_value += m_stride;
+			return result;
+		}
+
+		bool operator == (const Iterator & a) const { return m_value == a.m_value; }
+		bool operator != (const Iterator & a) const { return m_value != a.m_value; }
+
+	private:
+		T * m_value;
+		u32 m_stride;
+	};
+
+	MatrixView(T * data, u32 count, u32 stride) :
+		m_data(data), m_count(count), m_stride(stride){}
+
+	/*! \details Converts a view to a read-only view. */
+	template<typename U, typename = typename std::enable_if<
+						 std::is_same<const U, T>::value && !std::is_const<U>::value>::type>
+	MatrixView(const MatrixView<U> & a) :
+		m_data(a.data()), m_count(a.count()), m_stride(a.stride()){}
+
+	u32 count() const { return m_count; }
+	u32 stride() const { return m_stride; }
+	bool is_empty() const { return m_count == 0; }
+
+	/*! \details Returns true if the elements are next to each other in memory. */
+	bool is_contiguous() const { return (m_stride == 1) || (m_count < 2); }
+
+	/*! \details Returns a pointer to the first element. */
+	T * data() const { return m_data; }
+
+	T & at(u32 offset) const { return m_data[offset*m_stride]; }
+	T & operator[](u32 offset) const { return m_data[offset*m_stride]; }
+
+	Iterator begin() const { return Iterator(m_data, m_stride); }
+	Iterator end() const { return Iterator(m_data + m_count*m_stride, m_stride); }
+
+	/*! \details Copies the elements of the view to a new Vector. */
+	var::Vector<value_type> to_vector() const {
+		var::Vector<value_type> result;
+		result.reserve(m_count);
+		for(u32 i=0; i < m_count; i++){
+			result.push_back(at(i));
+		}
+		return result;
+	}
+
+private:
+	T * m_data;
+	u32 m_count;
+	u32 m_stride;
+};
+
+/*! \brief Matrix Class
+ * \details The Matrix class stores a table of values
+ * in a single row-major buffer.
+ *
+ * Rows and columns are accessed using MatrixView objects that
+ * refer to the buffer (nothing is copied). Iterating a Matrix
+ * visits each row.
+ *
+ * ```
+ * //md2code:main
+ * Matrix<float> matrix(2, 3);
+ * matrix.at(1, 2) = 5.0f;
+ * for(const auto & row: matrix){
+ *   for(float value: row){
+ *     printf("%f ", value);
+ *   }
+ *   printf("\n");
+ * }
+ * Matrix<float> transposed = matrix.transpose(); //3 rows, 2 columns
+ * ```
+ *
+ */
+template <typename T> class Matrix : public api::WorkObject {
 public:
 
+	using Row = MatrixView<T>;
+	using ConstRow = MatrixView<const T>;
+	using Column = MatrixView<T>;
+	using ConstColumn = MatrixView<const T>;
+
+	enum {
+		transpose_block_size /*! Rows and columns in each block copied by transpose() */ = 16
+	};
+
+	template<typename V> class RowIterator {
+	public:
+		RowIterator(V * data, u32 column_count, u32 row) :
+			m_data(data), m_column_count(column_count), m_row(row){}
+
+		MatrixView<V> operator*() const {
+			return MatrixView<V>(m_data + m_row*m_column_count, m_column_count, 1);
+		}
+
+		RowIterator & operator++(){
+			m_row++;
+			return *this;
+		}
+
+		bool operator == (const RowIterator & a) const { return m_row == a.m_row; }
+		bool operator != (const RowIterator & a) const { return m_row != a.m_row; }
+
+	private:
+		V * m_data;
+		u32 m_column_count;
+		u32 m_row;
+	};
+
+	using iterator = RowIterator<T>;
+	using const_iterator = RowIterator<const T>;
+
 	Matrix(){}
 
 	Matrix(u32 row_count, u32 column_count){
 		resize(row_count, column_count);
 	}
 
-	Matrix transform() const {
+	/*! \details Returns a new matrix with the rows and columns swapped.
+	 *
+	 * The copy is done in square blocks so that both the
+	 * source and destination stay in the cache on large matrices.
+	 *
+	 */
+	Matrix transpose() const {
 		Matrix result(column_count(), row_count());
-		for(u32 row_offset = 0; row_offset++; row_offset < row_count()){
-			for(u32 column_offset = 0; column_offset++; column_offset < column_count()){
-				result.at(column_offset, row_offset) = at(row_offset, column_offset);
+		const T * source = m_data.data();
+		T * destination = result.m_data.data();
+		for(u32 row_block = 0; row_block < m_row_count; row_block += transpose_block_size){
+			const u32 row_end = minimum(row_block + transpose_block_size, m_row_count);
+			for(u32 column_block = 0; column_block < m_column_count; column_block += transpose_block_size){
+				const u32 column_end = minimum(column_block + transpose_block_size, m_column_count);
+				for(u32 row_offset = row_block; row_offset < row_end; row_offset++){
+					for(u32 column_offset = column_block; column_offset < column_end; column_offset++){
+						destination[column_offset*m_row_count + row_offset] =
+								source[row_offset*m_column_count + column_offset];
+					}
+				}
 			}
 		}
 		return result;
 	}
 
+	/*! \details Same as transpose(). */
+	Matrix transform() const {
+		return transpose();
+	}
+
+	/*! \details Resizes the matrix.
+	 *
+	 * Values that are in both the old and new
+	 * sizes keep their row and column.
+	 *
+	 */
 	Matrix& resize(u32 row_count, u32 column_count){
-		var::Vector<T>::resize(row_count);
-		for(auto & local_row: *this){
-			local_row.resize(column_count);
+		if( column_count == m_column_count ){
+			m_data.resize(row_count * column_count);
+			m_row_count = row_count;
+			return *this;
+		}
+
+		var::Vector<T> data(row_count * column_count);
+		const u32 copy_rows = minimum(row_count, m_row_count);
+		const u32 copy_columns = minimum(column_count, m_column_count);
+		for(u32 row_offset = 0; row_offset < copy_rows; row_offset++){
+			for(u32 column_offset = 0; column_offset < copy_columns; column_offset++){
+				data[row_offset*column_count + column_offset] =
+						std::move(m_data[row_offset*m_column_count + column_offset]);
+			}
 		}
+		m_data = std::move(data);
+		m_row_count = row_count;
+		m_column_count = column_count;
 		return *this;
 	}
 
+	/*! \details Reserves memory for \a row_count rows
+	 * (the column count must already be set).
+	 *
+	 */
+	Matrix& reserve(u32 row_count){
+		m_data.reserve(row_count * m_column_count);
+		return *this;
+	}
+
+	/*! \details Appends a row to the matrix.
+	 *
+	 * The first row that is appended to an empty matrix sets the
+	 * column count. Rows that don't have column_count() values
+	 * are ignored.
+	 *
+	 */
 	Matrix& append(const var::Vector<T> & value){
-		if( (column_count() == 0) || (column_count() == value.count()) ){
-			this->push_back(value);
+		return append_rows(value.data(), value.count(), 1);
+	}
+
+	/*! \details Appends a row to the matrix by moving the values out of \a value. */
+	Matrix& append(var::Vector<T> && value){
+		if( is_append_size_valid(value.count(), 1) ){
+			for(T & item: value){
+				m_data.vector().push_back(std::move(item));
+			}
+			m_row_count++;
+		}
+		return *this;
+	}
+
+	/*! \details Appends a row (or column) of another matrix. */
+	Matrix& append(const ConstRow & value){
+		if( value.is_contiguous() ){
+			return append_rows(value.data(), value.count(), 1);
+		}
+		if( is_append_size_valid(value.count(), 1) ){
+			if( is_element(value.data()) ){
+				//a column of this matrix -- the buffer must not move while it is copied
+				const u32 offset = value.data() - m_data.data();
+				m_data.reserve(m_data.count() + value.count());
+				for(u32 i=0; i < value.count(); i++){
+					m_data.push_back(m_data[offset + i*value.stride()]);
+				}
+			} else {
+				for(const T & item: value){
+					m_data.push_back(item);
+				}
+			}
+			m_row_count++;
+		}
+		return *this;
+	}
+
+	/*! \details Appends \a row_count rows stored one after another
+	 * (row-major) in \a values using a single copy.
+	 *
+	 * @param values Pointer to row_count * column_count values
+	 * @param column_count Number of values in each row
+	 * @param row_count Number of rows to append
+	 *
+	 */
+	Matrix& append_rows(
+			const T * values,
+			u32 column_count,
+			u32 row_count
+			){
+		if( is_append_size_valid(column_count, row_count) ){
+			const u32 count = column_count*row_count;
+			if( is_element(values) ){
+				//values are in this matrix (such as append_rows(*this))
+				const u32 offset = values - m_data.data();
+				m_data.reserve(m_data.count() + count);
+				for(u32 i=0; i < count; i++){
+					m_data.push_back(m_data[offset + i]);
+				}
+			} else {
+				m_data.vector().insert(
+							m_data.end(),
+							values,
+							values + count
+							);
+			}
+			m_row_count += row_count;
 		}
 		return *this;
 	}
 
-	using var::Vector<var::Vector<T>>::at;
+	/*! \details Appends all the rows of \a value (which
+	 * must have the same number of columns).
+	 *
+	 */
+	Matrix& append_rows(const Matrix & value){
+		return append_rows(value.data(), value.column_count(), value.row_count());
+	}
+
+	Row row(u32 row_offset){
+		return Row(m_data.data() + row_offset*m_column_count, m_column_count, 1);
+	}
 
-	var::Vector<T> & row(u32 row_offset){
-		return at(row_offset);
+	ConstRow row(u32 row_offset) const {
+		return ConstRow(m_data.data() + row_offset*m_column_count, m_column_count, 1);
 	}
 
-	const var::Vector<T> & row(u32 row_offset) const {
-		return at(row_offset);
+	Column column(u32 column_offset){
+		return Column(m_data.data() + column_offset, m_row_count, m_column_count);
 	}
 
+	ConstColumn column(u32 column_offset) const {
+		return ConstColumn(m_data.data() + column_offset, m_row_count, m_column_count);
+	}
+
+	/*! \details Same as row(). */
+	Row at(u32 row_offset){ return row(row_offset); }
+	ConstRow at(u32 row_offset) const { return row(row_offset); }
+
 	T & at(u32 row_offset, u32 column_offset){
-		return at(row_offset).at(column_offset);
+		return m_data.at(row_offset*m_column_count + column_offset);
 	}
 
 	const T & at(u32 row_offset, u32 column_offset) const {
-		return row(row_offset).at(column_offset);
+		return m_data.at(row_offset*m_column_count + column_offset);
 	}
 
+	iterator begin(){ return iterator(m_data.data(), m_column_count, 0); }
+	iterator end(){ return iterator(m_data.data(), m_column_count, m_row_count); }
+	const_iterator begin() const { return const_iterator(m_data.data(), m_column_count, 0); }
+	const_iterator end() const { return const_iterator(m_data.data(), m_column_count, m_row_count); }
 
-	u32 row_count() const {
-		return this->count();
-	}
+	u32 row_count() const { return m_row_count; }
+	u32 column_count() const { return m_column_count; }
 
-	u32 column_count() const {
-		if( row_count() ){
-			return at(0).count();
-		}
-		return 0;
+	/*! \details Same as row_count(). */
+	u32 count() const { return m_row_count; }
+	bool is_empty() const { return m_row_count == 0; }
+
+	/*! \details Removes all the rows (the column count is kept). */
+	void clear(){
+		m_data.clear();
+		m_row_count = 0;
 	}
 
+	/*! \details Returns a pointer to the row-major values. */
+	T * data(){ return m_data.data(); }
+	const T * data() const { return m_data.data(); }
+
+	/*! \details Returns the row-major values. */
+	const var::Vector<T> & vector() const { return m_data; }
+
 private:
+	/*! \cond */
+	var::Vector<T> m_data;
+	u32 m_row_count = 0;
+	u32 m_column_count = 0;
 
+	static u32 minimum(u32 a, u32 b){ return a < b ? a : b; }
 
+	//true if value points in to this matrix's buffer
+	bool is_element(const T * value) const {
+		const T * start = m_data.data();
+		return !std::less<const T*>()(value, start) &&
+				std::less<const T*>()(value, start + m_data.count());
+	}
+
+	bool is_append_size_valid(u32 column_count, u32 row_count){
+		if( row_count == 0 ){ return false; }
+		if( m_row_count == 0 ){
+			//the first row sets the number of columns
+			m_column_count = column_count;
+			m_data.clear();
+			return true;
+		}
+		return column_count == m_column_count;
+	}
+	/*! \endcond */
 };
 
 
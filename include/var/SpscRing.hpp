@@ -0,0 +1,230 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_VAR_SPSCRING_HPP_
+#define SAPI_VAR_SPSCRING_HPP_
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include "Data.hpp"
+
+namespace var {
+
+/*! \brief Single Producer Single Consumer Ring Buffer
+ * \details SpscRing is a first in/first out ring buffer
+ * that can be shared by one producer thread and one
+ * consumer thread without a mutex.
+ *
+ * The producer is the only thread that may call write(), push(),
+ * reserve() and commit(). The consumer is the only thread that
+ * may call read(), pop(), peek() and consume(). The head and tail
+ * are atomic so each side sees the items the other side has
+ * finished with.
+ *
+ * Items are copied with memcpy() so \a T must be trivially copyable.
+ * Bulk transfers use at most two copies (one if the data doesn't
+ * wrap around the end of the buffer).
+ *
+ * ```
+ * //md2code:include
+ * #include <sapi/var.hpp>
+ * ```
+ *
+ * ```
+ * //md2code:main
+ * SpscRing<s16> samples(1024);
+ *
+ * //acquisition thread
+ * s16 input[64] = {0};
+ * samples.write(input, 64);
+ *
+ * //processing thread (zero-copy)
+ * const s16 * block;
+ * u32 count = samples.peek(block);
+ * //process count samples in block
+ * samples.consume(count);
+ * ```
+ *
+ * Unlike var::Ring, the buffer never overflows: write()
+ * only writes as many items as there is room for.
+ *
+ */
+template<typename T> class SpscRing {
+	static_assert(
+			std::is_trivially_copyable<T>::value,
+			"SpscRing requires a trivially copyable type"
+			);
+public:
+
+	/*! \details Constructs a new ring buffer that holds \a count items. */
+	explicit SpscRing(u32 count) : m_data(count * sizeof(T)){
+		m_count = count;
+	}
+
+	SpscRing(const SpscRing & a) = delete;
+	SpscRing & operator=(const SpscRing & a) = delete;
+
+	/*! \details Returns the number of items the ring can hold. */
+	u32 count() const { return m_count; }
+
+	/*! \details Returns the number of items that are ready to be read. */
+	u32 count_ready() const {
+		return used(
+					m_head.load(std::memory_order_acquire),
+					m_tail.load(std::memory_order_acquire)
+					);
+	}
+
+	/*! \details Returns the number of items that can be written. */
+	u32 count_free() const { return m_count - count_ready(); }
+
+	bool is_empty() const { return count_ready() == 0; }
+	bool is_full() const { return count_ready() == m_count; }
+
+	/*! \details Writes up to \a count items to the ring (producer only).
+	 *
+	 * @return The number of items that were written
+	 *
+	 */
+	u32 write(const T * items, u32 count){
+		T * destination;
+		u32 result = 0;
+		//at most two contiguous blocks are available
+		for(u32 i=0; (i < 2) && (result < count); i++){
+			u32 page_count = reserve(destination);
+			if( page_count == 0 ){ break; }
+			if( page_count > count - result ){
+				page_count = count - result;
+			}
+			memcpy(destination, items + result, page_count * sizeof(T));
+			commit(page_count);
+			result += page_count;
+		}
+		return result;
+	}
+
+	/*! \details Reads up to \a count items from the ring (consumer only).
+	 *
+	 * @return The number of items that were read
+	 *
+	 */
+	u32 read(T * items, u32 count){
+		const T * source;
+		u32 result = 0;
+		for(u32 i=0; (i < 2) && (result < count); i++){
+			u32 page_count = peek(source);
+			if( page_count == 0 ){ break; }
+			if( page_count > count - result ){
+				page_count = count - result;
+			}
+			memcpy(items + result, source, page_count * sizeof(T));
+			consume(page_count);
+			result += page_count;
+		}
+		return result;
+	}
+
+	/*! \details Writes one item (producer only).
+	 *
+	 * @return Zero on success or -1 if the ring is full
+	 */
+	int push(const T & value){
+		return write(&value, 1) == 1 ? 0 : -1;
+	}
+
+	/*! \details Reads one item (consumer only).
+	 *
+	 * @return Zero on success or -1 if the ring is empty
+	 */
+	int pop(T & value){
+		return read(&value, 1) == 1 ? 0 : -1;
+	}
+
+	/*! \details Gets the contiguous block of items that are ready
+	 * to be read (consumer only).
+	 *
+	 * @param items Assigned to the oldest item in the ring
+	 * @return The number of contiguous items at \a items
+	 *
+	 * The items remain in the ring until consume() is called. If the
+	 * ready items wrap around the end of the buffer, call peek()
+	 * again after consume() to get the rest.
+	 *
+	 */
+	u32 peek(const T *& items) const {
+		const u32 tail = m_tail.load(std::memory_order_relaxed);
+		const u32 head = m_head.load(std::memory_order_acquire);
+		const u32 index = position(tail);
+		u32 result = used(head, tail);
+		if( result > m_count - index ){
+			result = m_count - index;
+		}
+		items = m_data.template to<const T>() + index;
+		return result;
+	}
+
+	/*! \details Removes \a count items that were returned by peek() (consumer only). */
+	void consume(u32 count){
+		m_tail.store(
+					advance(m_tail.load(std::memory_order_relaxed), count),
+					std::memory_order_release
+					);
+	}
+
+	/*! \details Gets the contiguous block of free items (producer only).
+	 *
+	 * @param items Assigned to the next free item in the ring
+	 * @return The number of contiguous items that can be written to \a items
+	 *
+	 * The items are not readable until commit() is called.
+	 *
+	 */
+	u32 reserve(T *& items){
+		const u32 head = m_head.load(std::memory_order_relaxed);
+		const u32 tail = m_tail.load(std::memory_order_acquire);
+		const u32 index = position(head);
+		u32 result = m_count - used(head, tail);
+		if( result > m_count - index ){
+			result = m_count - index;
+		}
+		items = m_data.template to<T>() + index;
+		return result;
+	}
+
+	/*! \details Makes \a count items written to the block
+	 * returned by reserve() available to the consumer (producer only).
+	 */
+	void commit(u32 count){
+		m_head.store(
+					advance(m_head.load(std::memory_order_relaxed), count),
+					std::memory_order_release
+					);
+	}
+
+private:
+	/*! \cond */
+	//head and tail run from 0 to 2*count-1 so a full ring can be told apart from an empty one
+	Data m_data;
+	u32 m_count;
+	std::atomic<u32> m_head{0};
+	std::atomic<u32> m_tail{0};
+
+	u32 position(u32 value) const {
+		return value < m_count ? value : value - m_count;
+	}
+
+	u32 advance(u32 value, u32 count) const {
+		value += count;
+		return value < 2*m_count ? value : value - 2*m_count;
+	}
+
+	u32 used(u32 head, u32 tail) const {
+		return head >= tail ? head - tail : 2*m_count - (tail - head);
+	}
+	/*! \endcond */
+
+};
+
+} /* namespace var */
+
+#endif /* SAPI_VAR_SPSCRING_HPP_ */
@@ -10,12 +10,14 @@
 #include <cstdlib>
 #include <cstdio>
 #include <string>
+#include <algorithm>
 #include "../arg/Argument.hpp"
 #include "Vector.hpp"
 
 namespace var {
 
 class Reference;
+class StringReplacement;
 
 /*! \brief String class
  * \details This is an embedded friendly string class.  It is similar
@@ -387,6 +389,48 @@ public:
 		return replace(old_string.argument(), new_string, position, length);
 	}
 
+	using Replacement = StringReplacement;
+
+	/*! \details Replaces every instance of each
+	 * Replacement::from() with Replacement::to() in a single scan.
+	 *
+	 * @param replacement_list The strings to search for and their replacements
+	 * @return A reference to this string
+	 *
+	 * The string is scanned from left to right. Where more than one
+	 * replacement matches at the same position, the longest
+	 * from() string is used. Inserted text is not scanned again.
+	 *
+	 * ```
+	 * //md2code:main
+	 * String text = "Hello NAME, today is DAY";
+	 * text.replace_all({
+	 *   String::Replacement("NAME", "Tyler"),
+	 *   String::Replacement("DAY", "Monday")
+	 * });
+	 * ```
+	 *
+	 */
+	String& replace_all(const Vector<Replacement> & replacement_list);
+
+	/*! \details Erases (in place) each character
+	 * for which \a predicate returns true.
+	 *
+	 * ```
+	 * //md2code:main
+	 * String line = "a\tb\r\n";
+	 * line.erase_if([](char c){ return c == '\r' || c == '\n'; });
+	 * ```
+	 *
+	 */
+	template<typename Predicate> String& erase_if(Predicate predicate){
+		m_string.erase(
+					std::remove_if(m_string.begin(), m_string.end(), predicate),
+					m_string.end()
+					);
+		return *this;
+	}
+
 
 	size_t count(const var::String & to_count) const;
 	size_t length() const { return m_string.length(); }
@@ -454,6 +498,54 @@ public:
 	String& format(const char * format, ...);
 	String & vformat(const char * fmt, va_list list);
 
+	/*! \details Appends a formatted string to this String.
+	 *
+	 * The output is formatted directly in to the unused
+	 * capacity of the String (no temporary objects are
+	 * created). Use reserve() before building a long
+	 * string to allocate the memory only once.
+	 *
+	 * The arguments must not point in to this String (such
+	 * as cstring()) because the output is written over that
+	 * memory. format() can be used in that case.
+	 *
+	 * ```
+	 * //md2code:main
+	 * String report;
+	 * report.reserve(256);
+	 * for(u32 i=0; i < 8; i++){
+	 *   report.append_format("channel %ld: %0.3f\n", i, i*0.5f);
+	 * }
+	 * ```
+	 *
+	 */
+	String & append_format(const char * format, ...);
+	String & append_vformat(const char * fmt, va_list list);
+
+	/*! \details Appends \a value in decimal (without using printf()). */
+	String & append_integer(s64 value);
+
+	/*! \details Appends \a value in decimal (without using printf()). */
+	String & append_unsigned(u64 value);
+
+	/*! \details Appends \a value in hexadecimal (without a prefix).
+	 *
+	 * @param value The value to append
+	 * @param width Minimum number of digits (padded with zeros)
+	 * @param is_upper True to use upper-case letters
+	 *
+	 */
+	String & append_hex(u64 value, u32 width = 0, bool is_upper = false);
+
+	/*! \details Appends \a value with \a precision digits after the
+	 * decimal point (same as "%0.<precision>f").
+	 *
+	 * Values that are too large for the fast path are
+	 * formatted using printf().
+	 *
+	 */
+	String & append_float(float value, u32 precision = 6);
+
 	template<typename T> static String number(
 			T value,
 			const char * fmt = nullptr
@@ -900,6 +992,23 @@ String operator+ (const char*   lhs, String&& rhs);
 
 using StringList = Vector<String>;
 
+/*! \brief String Replacement Class
+ * \details Holds a string to search for and the
+ * string that replaces it (see String::replace_all()).
+ */
+class StringReplacement {
+public:
+	StringReplacement(){}
+	StringReplacement(
+			const String & from,
+			const String & to
+			) : m_from(from), m_to(to){}
+
+private:
+	API_ACCESS_COMPOUND(StringReplacement,String,from);
+	API_ACCESS_COMPOUND(StringReplacement,String,to);
+};
+
 }
 
 namespace sys {
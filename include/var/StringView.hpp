@@ -0,0 +1,148 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#ifndef SAPI_VAR_STRINGVIEW_HPP_
+#define SAPI_VAR_STRINGVIEW_HPP_
+
+#include <cstring>
+#include "String.hpp"
+#include "ConstString.hpp"
+#include "Reference.hpp"
+
+namespace var {
+
+/*! \brief String View Class
+ * \details The StringView class refers to a sequence of
+ * characters that is owned by something else (a var::String,
+ * a var::ConstString, a var::Reference or a plain C string).
+ *
+ * Creating, copying and taking sub views of a StringView
+ * never allocates memory. The characters are not necessarily
+ * null-terminated so use to_string() when a C string is needed.
+ *
+ * The object that owns the characters must outlive the view.
+ *
+ * ```
+ * //md2code:main
+ * String line = "temperature,21.5";
+ * StringView view(line);
+ * size_t comma = view.find(',');
+ * StringView name = view.sub_view(0, comma);
+ * if( name == "temperature" ){
+ *   printf("value is %s\n", view.sub_view(comma+1).to_string().cstring());
+ * }
+ * ```
+ *
+ */
+class StringView {
+public:
+
+	enum npos {
+		npos /*! Defines an invalid position */ = String::npos
+	};
+
+	StringView(){}
+
+	StringView(const char * cstring) //cppcheck-suppress[noExplicitConstructor]
+		: m_data(cstring), m_length(cstring ? strlen(cstring) : 0){}
+
+	StringView(const char * data, size_t length)
+		: m_data(data), m_length(length){}
+
+	StringView(const String & string) //cppcheck-suppress[noExplicitConstructor]
+		: m_data(string.cstring()), m_length(string.length()){}
+
+	explicit StringView(const ConstString & string)
+		: StringView(string.cstring()){}
+
+	explicit StringView(const Reference & reference)
+		: m_data(reference.to_const_char()), m_length(reference.size()){}
+
+	/*! \details Returns a pointer to the first character (not null-terminated). */
+	const char * data() const { return m_data; }
+	size_t length() const { return m_length; }
+	bool is_empty() const { return m_length == 0; }
+
+	char at(size_t position) const { return m_data[position]; }
+	char operator[](size_t position) const { return m_data[position]; }
+	char front() const { return m_data[0]; }
+	char back() const { return m_data[m_length-1]; }
+
+	const char * begin() const { return m_data; }
+	const char * end() const { return m_data + m_length; }
+
+	/*! \details Returns a view of part of this view.
+	 *
+	 * \a position and \a length are limited to the size of this view.
+	 *
+	 */
+	StringView sub_view(
+			size_t position,
+			size_t length = npos
+			) const {
+		if( position > m_length ){ position = m_length; }
+		if( length > m_length - position ){ length = m_length - position; }
+		return StringView(m_data + position, length);
+	}
+
+	/*! \details Returns the position of \a c or npos if not found. */
+	size_t find(char c, size_t position = 0) const {
+		if( position >= m_length ){ return npos; }
+		const void * result = memchr(m_data + position, c, m_length - position);
+		if( result == nullptr ){ return npos; }
+		return static_cast<const char*>(result) - m_data;
+	}
+
+	/*! \details Returns the position of \a view or npos if not found. */
+	size_t find(const StringView & view, size_t position = 0) const {
+		if( view.length() == 0 ){
+			return position <= m_length ? position : static_cast<size_t>(npos);
+		}
+		while( (position = find(view.front(), position)) != npos ){
+			if( view.length() > m_length - position ){ return npos; }
+			if( memcmp(m_data + position, view.data(), view.length()) == 0 ){
+				return position;
+			}
+			position++;
+		}
+		return npos;
+	}
+
+	/*! \details Compares this view with \a a (same result as strcmp()). */
+	int compare(const StringView & a) const {
+		size_t length = m_length < a.length() ? m_length : a.length();
+		int result = length ? memcmp(m_data, a.data(), length) : 0;
+		if( result ){ return result; }
+		if( m_length == a.length() ){ return 0; }
+		return m_length < a.length() ? -1 : 1;
+	}
+
+	bool operator == (const StringView & a) const {
+		return (m_length == a.length()) &&
+				((m_length == 0) || (memcmp(m_data, a.data(), m_length) == 0));
+	}
+
+	bool operator != (const StringView & a) const { return !(*this == a); }
+	bool operator < (const StringView & a) const { return compare(a) < 0; }
+
+	/*! \details Creates a (null-terminated) String that holds a copy of the view. */
+	String to_string() const {
+		if( m_length == 0 ){ return String(); }
+		return String(m_data, String::Length(m_length));
+	}
+
+	/*! \details Returns a read-only reference to the characters. */
+	Reference to_reference() const {
+		return Reference(
+					Reference::ReadOnlyBuffer(m_data),
+					Reference::Size(m_length)
+					);
+	}
+
+private:
+	const char * m_data = nullptr;
+	size_t m_length = 0;
+};
+
+}
+
+#endif // SAPI_VAR_STRINGVIEW_HPP_
@@ -5,6 +5,8 @@
 
 #include "../arg/Argument.hpp"
 #include "String.hpp"
+#include "StringView.hpp"
+#include "CharacterSet.hpp"
 #include "Vector.hpp"
 #include "Data.hpp"
 
@@ -95,6 +97,106 @@ public:
 			);
 
 
+	/*! \brief Tokenizer View Range
+	 * \details The ViewRange class splits an input in to
+	 * tokens without allocating any memory. Each token is
+	 * a var::StringView that refers to the input.
+	 *
+	 * Tokens are identical to the tokens created by parse()
+	 * using the same arguments.
+	 *
+	 * ```
+	 * //md2code:main
+	 * String line = "a,b,\"c,d\"";
+	 * for(StringView token: Tokenizer::parse_views(line, ",", "\"")){
+	 *   printf("%s\n", token.to_string().cstring());
+	 * }
+	 * ```
+	 *
+	 * The input must outlive the range and any tokens
+	 * that are used.
+	 *
+	 */
+	class ViewRange {
+	public:
+		class Iterator {
+		public:
+			const StringView & operator*() const { return m_token; }
+			const StringView * operator->() const { return &m_token; }
+
+			Iterator & operator++(){
+				m_range->load_next(*this);
+				return *this;
+			}
+
+			bool operator == (const Iterator & a) const {
+				return (m_is_end == a.m_is_end) &&
+						(m_is_end || (m_position == a.m_position));
+			}
+
+			bool operator != (const Iterator & a) const { return !(*this == a); }
+
+		private:
+			friend class ViewRange;
+			const ViewRange * m_range = nullptr;
+			StringView m_token;
+			size_t m_position = 0; //start of the next token
+			u32 m_count = 0; //number of tokens ended by a delimeter
+			bool m_is_last = false;
+			bool m_is_end = true;
+		};
+
+		ViewRange(
+				const StringView & input,
+				const StringView & delimeters,
+				const StringView & ignore_between = StringView(),
+				u32 maximum_delimeter_count = 0
+				);
+
+		Iterator begin() const;
+		Iterator end() const { return Iterator(); }
+
+		/*! \details Returns the number of tokens (this scans the input). */
+		u32 count() const;
+
+		const StringView & input() const { return m_input; }
+
+		/*! \details Returns the position of the next delimeter at or after
+		 * \a position (skipping ignore-between sections) or the length of
+		 * the input if there are no more delimeters.
+		 */
+		size_t find_delimeter(size_t position) const;
+
+	private:
+		StringView m_input;
+		u32 m_maximum_delimeter_count;
+		//delimeters and ignore-between characters
+		CharacterSet m_special_set;
+		CharacterSet m_ignore_between_set;
+
+		void load_next(Iterator & iterator) const;
+	};
+
+	/*! \details Returns a range of tokens (as var::StringView objects)
+	 * without allocating any memory.
+	 *
+	 * The arguments are the same as parse().
+	 *
+	 */
+	static ViewRange parse_views(
+			const StringView & input,
+			const StringView & delimeters,
+			const StringView & ignore_between = StringView(),
+			u32 maximum_delimeter_count = 0
+			){
+		return ViewRange(
+					input,
+					delimeters,
+					ignore_between,
+					maximum_delimeter_count
+					);
+	}
+
 	/*! \details Sorts the tokens as specified. */
 	void sort(enum sort_option sort_option = sort_option_none);
 
@@ -131,6 +131,9 @@ const char * api::get_error_code_description(s32 ec){
 		ERROR_CODE_CASE(error_code_flag_ux);
 		ERROR_CODE_CASE(error_code_flag_var);
 
+		ERROR_CODE_CASE(error_code_calc_lz_bad_format);
+		ERROR_CODE_CASE(error_code_calc_lz_corrupt_block);
+
 		ERROR_CODE_CASE(error_code_crypto_size_mismatch);
 		ERROR_CODE_CASE(error_code_crypto_bad_block_size);
 		ERROR_CODE_CASE(error_code_crypto_operation_failed);
@@ -139,6 +142,9 @@ const char * api::get_error_code_description(s32 ec){
 		ERROR_CODE_CASE(error_code_crypto_bad_iv_size);
 
 
+		ERROR_CODE_CASE(error_code_fmt_csv_unterminated_quote);
+		ERROR_CODE_CASE(error_code_fmt_csv_column_not_found);
+
 		ERROR_CODE_CASE(error_code_fs_failed_to_open);
 		ERROR_CODE_CASE(error_code_fs_failed_to_read);
 		ERROR_CODE_CASE(error_code_fs_failed_to_write);
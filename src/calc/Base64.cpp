@@ -5,238 +5,566 @@
 #include <cstdio>
 #include <cstring>
 #include "calc/Base64.hpp"
+#include "var/Data.hpp"
+
+#if defined __link && defined __GNUC__ && defined __x86_64__
+#define SAPI_BASE64_X86 1
+#include <immintrin.h>
+#endif
 
 using namespace calc;
 
+namespace {
+
+const char encode_table[65] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+//characters that are not part of the alphabet decode as zero
+const u8 decode_table[256] = {
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 62,  0,  0,  0, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61,  0,  0,  0,  0,  0,  0,
+	 0,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,  0,  0,  0,  0,  0,
+	 0, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+};
+
+u32 encode_scalar(char * dest, const u8 * src, u32 nbyte){
+	char * output = dest;
+	u32 i;
+
+	//three bytes are encoded as four characters
+	for(i=0; i + 3 <= nbyte; i += 3){
+		const u32 value = (src[i] << 16) | (src[i+1] << 8) | src[i+2];
+		output[0] = encode_table[value >> 18];
+		output[1] = encode_table[(value >> 12) & 0x3f];
+		output[2] = encode_table[(value >> 6) & 0x3f];
+		output[3] = encode_table[value & 0x3f];
+		output += 4;
+	}
+
+	//pad with = if the input is not divisible by 3
+	const u32 remaining = nbyte - i;
+	if( remaining == 1 ){
+		const u32 value = src[i] << 16;
+		output[0] = encode_table[value >> 18];
+		output[1] = encode_table[(value >> 12) & 0x3f];
+		output[2] = '=';
+		output[3] = '=';
+		output += 4;
+	} else if( remaining == 2 ){
+		const u32 value = (src[i] << 16) | (src[i+1] << 8);
+		output[0] = encode_table[value >> 18];
+		output[1] = encode_table[(value >> 12) & 0x3f];
+		output[2] = encode_table[(value >> 6) & 0x3f];
+		output[3] = '=';
+		output += 4;
+	}
+
+	return output - dest;
+}
+
+u32 decode_scalar(u8 * dest, const char * src, u32 nbyte){
+	const u8 * input = reinterpret_cast<const u8*>(src);
+	u8 * output = dest;
+	u32 j;
+
+	for(j=0; j + 4 <= nbyte; j += 4){
+		const u32 value =
+				(decode_table[input[j]] << 18) |
+				(decode_table[input[j+1]] << 12) |
+				(decode_table[input[j+2]] << 6) |
+				decode_table[input[j+3]];
+		output[0] = value >> 16;
+		output[1] = value >> 8;
+		output[2] = value;
+		output += 3;
+	}
+
+	if( j >= 4 ){
+		if( src[j-4+2] == '=' ){
+			output -= 2;
+		} else if( src[j-4+3] == '=' ){
+			output -= 1;
+		}
+	}
+
+	//input that isn't padded to a multiple of 4
+	const u32 remaining = nbyte - j;
+	if( remaining > 1 ){
+		const u32 value =
+				(decode_table[input[j]] << 18) |
+				(decode_table[input[j+1]] << 12) |
+				(remaining > 2 ? (decode_table[input[j+2]] << 6) : 0);
+		*output++ = value >> 16;
+		if( remaining > 2 ){
+			*output++ = value >> 8;
+		}
+	}
+
+	return output - dest;
+}
+
+#if defined SAPI_BASE64_X86
+
+/*
+ * The vector versions follow Muła and Lemire, "Faster Base64
+ * Encoding and Decoding Using AVX2 Instructions". They return the
+ * number of input bytes used and leave the rest (including any
+ * padding) to the scalar versions.
+ *
+ */
+
+enum simd_level {
+	simd_level_none,
+	simd_level_ssse3,
+	simd_level_avx2
+};
+
+simd_level get_simd_level(){
+	static const simd_level level =
+			__builtin_cpu_supports("avx2") ? simd_level_avx2 :
+			(__builtin_cpu_supports("ssse3") ? simd_level_ssse3 : simd_level_none);
+	return level;
+}
+
+__attribute__((target("ssse3")))
+inline __m128i encode_lookup_ssse3(__m128i indices){
+	//map each range of indices to the offset from the index to the character
+	__m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+	const __m128i shift_table = _mm_setr_epi8(
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				'/' - 63, 'A', 0, 0
+				);
+	result = _mm_shuffle_epi8(shift_table, result);
+	return _mm_add_epi8(result, indices);
+}
+
+__attribute__((target("ssse3")))
+u32 encode_ssse3(char * dest, const u8 * src, u32 nbyte){
+	u32 i = 0;
+	//16 bytes are loaded but only 12 are used
+	for(; i + 16 <= nbyte; i += 12){
+		__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		input = _mm_shuffle_epi8(
+					input,
+					_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1)
+					);
+		const __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+		const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+		const __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+		const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+		_mm_storeu_si128(
+					reinterpret_cast<__m128i*>(dest + i/3*4),
+					encode_lookup_ssse3(_mm_or_si128(t1, t3))
+					);
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+u32 encode_avx2(char * dest, const u8 * src, u32 nbyte){
+	u32 i = 0;
+	const __m256i shuffle = _mm256_setr_epi8(
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+				);
+	const __m256i shift_table = _mm256_setr_epi8(
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				'/' - 63, 'A', 0, 0,
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				'/' - 63, 'A', 0, 0
+				);
+
+	//each lane gets 12 bytes (the last lane load reads 4 extra bytes)
+	for(; i + 28 <= nbyte; i += 24){
+		__m256i input = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))
+						),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12)),
+					1
+					);
+		input = _mm256_shuffle_epi8(input, shuffle);
+		const __m256i t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00));
+		const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		const __m256i t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0));
+		const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		const __m256i indices = _mm256_or_si256(t1, t3);
+
+		__m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+		result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+		result = _mm256_shuffle_epi8(shift_table, result);
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(dest + i/3*4),
+					_mm256_add_epi8(result, indices)
+					);
+	}
+	return i;
+}
+
+/*
+ * The decoders stop at the first block that has a character
+ * outside of the alphabet (such as padding). They write 4 (SSSE3)
+ * or 8 (AVX2) bytes past the end of each block so they leave
+ * enough input to be sure the destination has room for it.
+ *
+ */
+__attribute__((target("ssse3")))
+u32 decode_ssse3(u8 * dest, const char * src, u32 nbyte){
+	const __m128i lo_table = _mm_setr_epi8(
+				0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a
+				);
+	const __m128i hi_table = _mm_setr_epi8(
+				0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+				);
+	const __m128i roll_table = _mm_setr_epi8(
+				0, 16, 19, 4, -65, -65, -71, -71,
+				0, 0, 0, 0, 0, 0, 0, 0
+				);
+	const __m128i mask = _mm_set1_epi8(0x0f);
+
+	u32 j = 0;
+	for(; j + 24 <= nbyte; j += 16){
+		const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+		const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(input, 4), mask);
+		const __m128i lo_nibbles = _mm_and_si128(input, mask);
+		const __m128i lo = _mm_shuffle_epi8(lo_table, lo_nibbles);
+		const __m128i hi = _mm_shuffle_epi8(hi_table, hi_nibbles);
+		if( _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) ){
+			break;
+		}
+
+		const __m128i is_slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+		const __m128i roll = _mm_shuffle_epi8(roll_table, _mm_add_epi8(is_slash, hi_nibbles));
+		const __m128i values = _mm_add_epi8(input, roll);
+
+		const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+		__m128i output = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+		output = _mm_shuffle_epi8(
+					output,
+					_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+					);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j/4*3), output);
+	}
+	return j;
+}
+
+__attribute__((target("avx2")))
+u32 decode_avx2(u8 * dest, const char * src, u32 nbyte){
+	const __m256i lo_table = _mm256_broadcastsi128_si256(
+				_mm_setr_epi8(
+					0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+					0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a
+					)
+				);
+	const __m256i hi_table = _mm256_broadcastsi128_si256(
+				_mm_setr_epi8(
+					0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+					0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+					)
+				);
+	const __m256i roll_table = _mm256_broadcastsi128_si256(
+				_mm_setr_epi8(
+					0, 16, 19, 4, -65, -65, -71, -71,
+					0, 0, 0, 0, 0, 0, 0, 0
+					)
+				);
+	const __m256i pack = _mm256_broadcastsi128_si256(
+				_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+				);
+	const __m256i mask = _mm256_set1_epi8(0x0f);
+
+	u32 j = 0;
+	for(; j + 48 <= nbyte; j += 32){
+		const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j));
+		const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), mask);
+		const __m256i lo_nibbles = _mm256_and_si256(input, mask);
+		const __m256i lo = _mm256_shuffle_epi8(lo_table, lo_nibbles);
+		const __m256i hi = _mm256_shuffle_epi8(hi_table, hi_nibbles);
+		if( !_mm256_testz_si256(lo, hi) ){
+			break;
+		}
+
+		const __m256i is_slash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+		const __m256i roll = _mm256_shuffle_epi8(roll_table, _mm256_add_epi8(is_slash, hi_nibbles));
+		const __m256i values = _mm256_add_epi8(input, roll);
+
+		const __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		__m256i output = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+		output = _mm256_shuffle_epi8(output, pack);
+		//move the 12 bytes from each lane next to each other
+		output = _mm256_permutevar8x32_epi32(output, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + j/4*3), output);
+	}
+	return j;
+}
+
+#endif
+
+}
+
 int Base64::encode(
 		SourceFile source,
 		DestinationFile destination,
-		Size size
+		Size size,
+		PageSize page_size
 		){
-	u32 chunk_size = 96;
-	const u32 output_buffer_size = calc_encoded_size(chunk_size);
-	char input_buffer[chunk_size];
-	char output_buffer[output_buffer_size];
+	//whole groups of 3 so padding is only added at the end
+	u32 chunk_size = page_size.argument() / 3 * 3;
+	if( chunk_size == 0 ){
+		chunk_size = 3;
+	}
+
+	var::Data input_buffer(chunk_size);
+	var::Data output_buffer(calc_encoded_size(chunk_size));
+	if( (input_buffer.size() != chunk_size) ||
+			(output_buffer.size() != calc_encoded_size(chunk_size)) ){
+		return -1;
+	}
+
+	const u32 total_size = size.argument();
 	u32 size_processed = 0;
-	int result;
+	u32 pending = 0;
+	bool is_last;
 	do {
-		if( size.argument() - size_processed < chunk_size ){
-			chunk_size = size.argument() - size_processed;
+		u32 read_size = chunk_size - pending;
+		if( total_size && (total_size - size_processed < read_size) ){
+			read_size = total_size - size_processed;
 		}
-		result = source.argument().read(
-					input_buffer,
-					fs::File::Size(chunk_size)
-					);
-		if( result > 0 ){
-			size_processed += result;
-			int len = encode(output_buffer, input_buffer, result);
+
+		int result = 0;
+		if( read_size ){
+			result = source.argument().read(
+						input_buffer.to_u8() + pending,
+						fs::File::Size(read_size)
+						);
+			if( result < 0 ){
+				return -1;
+			}
+		}
+
+		size_processed += result;
+		pending += result;
+		is_last = (result == 0) || (total_size && (size_processed == total_size));
+
+		//a short read can leave a partial group for next time
+		const u32 encode_size = is_last ? pending : pending / 3 * 3;
+		if( encode_size ){
+			const u32 length = encode(
+						output_buffer.to_char(),
+						input_buffer.to_const_u8(),
+						encode_size
+						);
 			if( destination.argument().write(
-						output_buffer,
-						fs::File::Size(len)
-						) != len ){
-				result = 0;
+						output_buffer.to_const_char(),
+						fs::File::Size(length)
+						) != static_cast<int>(length) ){
+				return -1;
 			}
+			pending -= encode_size;
+			memmove(input_buffer.to_u8(), input_buffer.to_const_u8() + encode_size, pending);
 		}
-	} while( (result > 0) && (size.argument() > size_processed) );
+	} while( !is_last );
+
 	return size_processed;
 }
 
 int Base64::decode(
 		SourceFile input,
 		DestinationFile output,
-		Size size
+		Size size,
+		PageSize page_size
 		){
-	u32 chunk_size = 96;
-	const u32 output_buffer_size = calc_decoded_size(chunk_size);
-	char input_buffer[chunk_size];
-	char output_buffer[output_buffer_size];
-	u32 size_processed = 0;
-	int result;
+	u32 chunk_size = page_size.argument() / 4 * 4;
+	if( chunk_size == 0 ){
+		chunk_size = 4;
+	}
+
+	var::Data input_buffer(chunk_size);
+	var::Data output_buffer(calc_decoded_size(chunk_size));
+	if( (input_buffer.size() != chunk_size) ||
+			(output_buffer.size() != calc_decoded_size(chunk_size)) ){
+		return -1;
+	}
 
+	const u32 total_size = size.argument();
+	u32 size_processed = 0;
+	u32 pending = 0;
+	bool is_last;
 	do {
-		if( size.argument() - size_processed < chunk_size ){
-			chunk_size = size.argument() - size_processed;
+		u32 read_size = chunk_size - pending;
+		if( total_size && (total_size - size_processed < read_size) ){
+			read_size = total_size - size_processed;
 		}
-		result = input.argument().read(
-					input_buffer,
-					fs::File::Size(chunk_size)
-					);
-		if( result > 0 ){
-			size_processed += result;
-			int len = calc_decoded_size(result);
-			len -= decode(output_buffer, input_buffer, result);
-			if( output.argument().write(
-						output_buffer,
-						fs::File::Size(len)
-						) != len ){
-				result = 0;
+
+		int result = 0;
+		if( read_size ){
+			result = input.argument().read(
+						input_buffer.to_char() + pending,
+						fs::File::Size(read_size)
+						);
+			if( result < 0 ){
+				return -1;
 			}
+		}
 
+		size_processed += result;
+		pending += result;
+		is_last = (result == 0) || (total_size && (size_processed == total_size));
+
+		const u32 decode_size = is_last ? pending : pending / 4 * 4;
+		if( decode_size ){
+			const u32 length = decode(
+						output_buffer.to_u8(),
+						input_buffer.to_const_char(),
+						decode_size
+						);
+			if( output.argument().write(
+						output_buffer.to_const_u8(),
+						fs::File::Size(length)
+						) != static_cast<int>(length) ){
+				return -1;
+			}
+			pending -= decode_size;
+			memmove(input_buffer.to_u8(), input_buffer.to_const_u8() + decode_size, pending);
 		}
-	} while( (result > 0) && (size.argument() > size_processed) );
+	} while( !is_last );
 
 	return size_processed;
 }
 
-var::String Base64::encode(const var::Reference& input
+var::String Base64::encode(
+		const var::Reference& input
 		){
 	var::String result;
+	encode(input, result);
+	return result;
+}
 
-	result.resize(
-				calc_encoded_size(input.size())
-				);
+int Base64::encode(
+		const var::Reference & source,
+		var::String & destination,
+		const Size size
+		){
+	u32 nbyte = source.size();
+	if( size.argument() && (size.argument() < nbyte) ){
+		nbyte = size.argument();
+	}
 
-	encode(result.to_char(),
-				 input.to_const_void(),
-				 input.size());
+	destination.resize(calc_encoded_size(nbyte));
+	if( destination.length() != calc_encoded_size(nbyte) ){
+		return -1;
+	}
 
-	return result;
+	return encode(
+				destination.to_char(),
+				source.to_const_void(),
+				nbyte
+				);
 }
 
 var::Data Base64::decode(
 		const var::String & input
 		){
 	var::Data result;
-	int len	= calc_decoded_size(input.length());
-	if( result.allocate(len) < 0 ){
+	if( decode(input, result) < 0 ){
 		return var::Data();
 	}
-
-	len -= decode(
-				result.to_void(),
-				input.cstring(),
-				input.length()
-				);
-
-	result.resize(len);
 	return result;
 }
 
-int Base64::encode(
-		char * dest,
-		const void * src,
-		int nbyte
+int Base64::decode(
+		const var::StringView & input,
+		var::Data & destination
 		){
-
-	int i;
-	int j;
-	int k;
-	int len;
-	u8 six_bits[4];
-	len = nbyte;
-	const char * data;
-	data = (const char *)src;
-
-	k = 0;
-	//We need to encode three bytes at a time in to four encoded bytes
-	for(i=0; i < len; i+=3){
-		//First the thress bytes are broken down into six-bit sections
-		six_bits[0] = (data[i] >> 2) & 0x3F;
-		six_bits[1] = ((data[i] << 4) & 0x30) + ((data[i+1]>>4) & 0x0F);
-		six_bits[2] = ((data[i+1] << 2) & 0x3C) + ((data[i+2]>>6) & 0x03);
-		six_bits[3] = data[i+2] & 0x3F;
-		//now we use the helper function to convert from six-bits to base64
-		for(j=0; j < 4; j++){
-			dest[k+j] = encode_six(six_bits[j]);
-		}
-		k+=4;
+	if( destination.allocate(calc_decoded_size(input.length())) < 0 ){
+		return -1;
 	}
 
-	//at the end, we add = if the input is not divisible by 3
-	if( (len % 3) == 1 ){
-		//two equals at end
-		dest[k-2] = '=';
-		dest[k-1] = '=';
-	} else if ( (len % 3) == 2 ){
-		dest[k-1] = '=';
-	}
-
-	//finally, zero terminate the output string
-	dest[k] = 0;
-
-	return strlen(dest);
-}
+	const u32 length = decode(
+				destination.to_void(),
+				input.data(),
+				input.length()
+				);
 
-int Base64::calc_encoded_size(int nbyte){
-	return ((((nbyte*4+2)/3) + 3)/4)*4;
+	//shrinking doesn't reallocate
+	destination.resize(length);
+	return length;
 }
 
-int Base64::decode(void * dest, const char * src, int nbyte){
-	char * data = (char *)dest;
-	int i;
-	int j;
-
-	u8 eight_bits[4] = {0};
-
-	for(i=0,j=0; j < nbyte; i+=3,j+=4){
-		eight_bits[0] = decode_eigth(src[j]);
-		eight_bits[1] = decode_eigth(src[j+1]);
-		eight_bits[2] = decode_eigth(src[j+2]);
-		eight_bits[3] = decode_eigth(src[j+3]);
-		data[i] = (eight_bits[0] << 2) | (eight_bits[1] >> 4);
-		data[i+1] = (eight_bits[1] << 4) | (eight_bits[2] >> 2);
-		data[i+2] = (eight_bits[2] << 6) | (eight_bits[3]);
-	}
-
-	int padding = 0;
-	if( j >= 4 ){
-		if( src[j-4+2] == '=' ){
-			padding = 2;
-		} else if( src[j-4+3] == '=' ){
-			padding = 1;
-		}
+u32 Base64::encode(
+		char * dest,
+		const void * src,
+		u32 nbyte
+		){
+	const u8 * data = static_cast<const u8*>(src);
+	u32 offset = 0;
+
+#if defined SAPI_BASE64_X86
+	switch( get_simd_level() ){
+		case simd_level_avx2:
+			offset = encode_avx2(dest, data, nbyte);
+			//the SSSE3 version can take part of what is left
+			offset += encode_ssse3(dest + offset/3*4, data + offset, nbyte - offset);
+			break;
+		case simd_level_ssse3:
+			offset = encode_ssse3(dest, data, nbyte);
+			break;
+		case simd_level_none:
+			break;
 	}
+#endif
 
-	return padding;
-}
-
-int Base64::calc_decoded_size(int nbyte){
-	//doesn't account for padding
-	return (nbyte*3+3)/4;
-}
-
-//This is a helper function to convert a six-bit value to base64
-char Base64::encode_six(u8 six_bit_value){
-	u8 x;
-	char c = -1;
-	x = six_bit_value & ~0xC0; //remove top two bits (should be zero anyway)
-	if( x < 26 ){
-		c = 'A' + x;
-	} else if ( x < 52 ){
-		c = 'a' + (x - 26);
-	} else if( x < 62 ){
-		c = '0' + (x - 52);
-	} else if( x == 62 ){
-		c = '+';
-	} else if (x == 63 ){
-		c = '/';
-	}
-	return c;
+	return offset/3*4 + encode_scalar(
+				dest + offset/3*4,
+				data + offset,
+				nbyte - offset
+				);
 }
 
-char Base64::decode_eigth(u8 eight_bit_value){
-	u8 x;
-	x = eight_bit_value;
-	if( (x >= 'A') && (x <= 'Z') ){
-		return x - 'A';
-	}
-
-	if( (x >= 'a') && (x <= 'z') ){
-		return x - 'a' + 26;
+u32 Base64::decode(void * dest, const char * src, u32 nbyte){
+	u8 * data = static_cast<u8*>(dest);
+	u32 offset = 0;
+
+#if defined SAPI_BASE64_X86
+	switch( get_simd_level() ){
+		case simd_level_avx2:
+			offset = decode_avx2(data, src, nbyte);
+			offset += decode_ssse3(data + offset/4*3, src + offset, nbyte - offset);
+			break;
+		case simd_level_ssse3:
+			offset = decode_ssse3(data, src, nbyte);
+			break;
+		case simd_level_none:
+			break;
 	}
+#endif
 
-	if( (x >= '0') && (x <= '9') ){
-		return x - '0' + 52;
-	}
-
-	if( x == '+' ){
-		return 62;
-	}
-
-	if( x == '/' ){
-		return 63;
-	}
-
-	return 0;
+	return offset/4*3 + decode_scalar(
+				data + offset/4*3,
+				src + offset,
+				nbyte - offset
+				);
 }
-
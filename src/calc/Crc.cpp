@@ -0,0 +1,445 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include "calc/Crc.hpp"
+#include "var/Data.hpp"
+
+#if defined __link && defined __GNUC__ && defined __x86_64__
+#define SAPI_CRC_X86 1
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#include <smmintrin.h>
+#endif
+
+using namespace calc;
+
+namespace {
+
+#if defined __link
+//8 KB per type (only built when the type is used)
+const u32 slice_count = 8;
+#else
+//1 KB per type
+const u32 slice_count = 1;
+#endif
+
+class CrcParameters {
+public:
+	u32 width;
+	u32 polynomial;
+	u32 initial_value;
+	u32 final_xor;
+	bool is_reflected;
+};
+
+const CrcParameters parameter_list[Crc::type_total] = {
+	{ 8, 0x07, 0x00, 0x00, false },
+	{ 16, 0x1021, 0xffff, 0x0000, false },
+	{ 32, 0x04c11db7, 0xffffffff, 0xffffffff, true },
+	{ 32, 0x1edc6f41, 0xffffffff, 0xffffffff, true }
+};
+
+u32 reflect(u32 value, u32 width){
+	u32 result = 0;
+	for(u32 i=0; i < width; i++){
+		if( value & (1UL << i) ){
+			result |= 1UL << (width - 1 - i);
+		}
+	}
+	return result;
+}
+
+/*
+ * The register is 32 bits wide for every type. Reflected
+ * CRCs keep the value in the low bits and shift right. Other CRCs
+ * keep the value in the high bits and shift left so the same
+ * tables and loops work for all widths.
+ *
+ */
+class CrcTable {
+public:
+	explicit CrcTable(const CrcParameters & parameters){
+		const bool is_reflected = parameters.is_reflected;
+		const u32 polynomial = is_reflected ?
+					reflect(parameters.polynomial, parameters.width) :
+					parameters.polynomial << (32 - parameters.width);
+
+		for(u32 i=0; i < 256; i++){
+			u32 value;
+			if( is_reflected ){
+				value = i;
+				for(u32 bit=0; bit < 8; bit++){
+					value = (value & 1) ? (value >> 1) ^ polynomial : value >> 1;
+				}
+			} else {
+				value = i << 24;
+				for(u32 bit=0; bit < 8; bit++){
+					value = (value & 0x80000000) ? (value << 1) ^ polynomial : value << 1;
+				}
+			}
+			table[0][i] = value;
+		}
+
+		//each slice is the previous slice followed by a zero byte
+		for(u32 slice=1; slice < slice_count; slice++){
+			for(u32 i=0; i < 256; i++){
+				const u32 value = table[slice-1][i];
+				table[slice][i] = is_reflected ?
+							(value >> 8) ^ table[0][value & 0xff] :
+							(value << 8) ^ table[0][value >> 24];
+			}
+		}
+	}
+
+	u32 table[slice_count][256];
+};
+
+const CrcTable & table(enum Crc::type type){
+	//built on first use
+	switch(type){
+		case Crc::type_crc8: { static const CrcTable result(parameter_list[Crc::type_crc8]); return result; }
+		case Crc::type_crc16: { static const CrcTable result(parameter_list[Crc::type_crc16]); return result; }
+		case Crc::type_crc32c: { static const CrcTable result(parameter_list[Crc::type_crc32c]); return result; }
+		default: break;
+	}
+	static const CrcTable result(parameter_list[Crc::type_crc32]);
+	return result;
+}
+
+u32 load_le32(const u8 * data){
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<u32>(data[3]) << 24);
+}
+
+u32 load_be32(const u8 * data){
+	return (static_cast<u32>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+u32 update_reflected(
+		const u32 (*table)[256],
+		u32 value,
+		const u8 * data,
+		u32 size
+		){
+	if( slice_count == 8 ){
+		while( size >= 8 ){
+			value ^= load_le32(data);
+			value = table[7][value & 0xff] ^
+					table[6][(value >> 8) & 0xff] ^
+					table[5][(value >> 16) & 0xff] ^
+					table[4][value >> 24] ^
+					table[3][data[4]] ^
+					table[2][data[5]] ^
+					table[1][data[6]] ^
+					table[0][data[7]];
+			data += 8;
+			size -= 8;
+		}
+	}
+
+	while( size-- ){
+		value = (value >> 8) ^ table[0][(value ^ *data++) & 0xff];
+	}
+	return value;
+}
+
+u32 update_normal(
+		const u32 (*table)[256],
+		u32 value,
+		const u8 * data,
+		u32 size
+		){
+	if( slice_count == 8 ){
+		while( size >= 8 ){
+			value ^= load_be32(data);
+			value = table[7][value >> 24] ^
+					table[6][(value >> 16) & 0xff] ^
+					table[5][(value >> 8) & 0xff] ^
+					table[4][value & 0xff] ^
+					table[3][data[4]] ^
+					table[2][data[5]] ^
+					table[1][data[6]] ^
+					table[0][data[7]];
+			data += 8;
+			size -= 8;
+		}
+	}
+
+	while( size-- ){
+		value = (value << 8) ^ table[0][(value >> 24) ^ *data++];
+	}
+	return value;
+}
+
+#if defined SAPI_CRC_X86
+bool is_sse42_supported(){
+	static const bool result = __builtin_cpu_supports("sse4.2");
+	return result;
+}
+
+bool is_pclmul_supported(){
+	static const bool result = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+	return result;
+}
+
+__attribute__((target("sse4.2")))
+u32 update_crc32c_sse42(u32 value, const u8 * data, u32 size){
+	u64 wide_value = value;
+	while( size >= 8 ){
+		u64 word;
+		memcpy(&word, data, sizeof(word));
+		wide_value = _mm_crc32_u64(wide_value, word);
+		data += 8;
+		size -= 8;
+	}
+
+	value = static_cast<u32>(wide_value);
+	while( size-- ){
+		value = _mm_crc32_u8(value, *data++);
+	}
+	return value;
+}
+
+/*
+ * Folds 64 bytes at a time using carry-less multiplication then
+ * uses a Barrett reduction for the final 32 bits (see Intel's
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ").
+ *
+ * size must be at least 64 and a multiple of 16.
+ *
+ */
+__attribute__((target("pclmul,sse4.1")))
+u32 update_crc32_pclmul(u32 value, const u8 * data, u32 size){
+	alignas(16) static const u64 k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+	alignas(16) static const u64 k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+	alignas(16) static const u64 k5k0[] = { 0x0163cd6124, 0x0000000000 };
+	alignas(16) static const u64 poly[] = { 0x01db710641, 0x01f7011641 };
+
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+	x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+	x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+	x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+	x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(value));
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+	data += 64;
+	size -= 64;
+
+	//fold by 4
+	while( size >= 64 ){
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+		data += 64;
+		size -= 64;
+	}
+
+	//fold in to 128 bits
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	//remaining 16 byte blocks
+	while( size >= 16 ){
+		x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		data += 16;
+		size -= 16;
+	}
+
+	//fold 128 bits to 64 bits
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+	x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	//Barrett reduction to 32 bits
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	return static_cast<u32>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+//multiplies a 32x32 GF(2) matrix by a vector
+u32 gf2_matrix_times(const u32 * matrix, u32 vector){
+	u32 result = 0;
+	while( vector ){
+		if( vector & 1 ){
+			result ^= *matrix;
+		}
+		vector >>= 1;
+		matrix++;
+	}
+	return result;
+}
+
+void gf2_matrix_square(u32 * square, const u32 * matrix){
+	for(u32 i=0; i < 32; i++){
+		square[i] = gf2_matrix_times(matrix, matrix[i]);
+	}
+}
+
+}
+
+Crc::Crc(enum type type){
+	m_type = type < type_total ? type : type_crc32;
+	reset();
+}
+
+Crc & Crc::reset(){
+	const CrcParameters & parameters = parameter_list[m_type];
+	m_register = parameters.is_reflected ?
+				reflect(parameters.initial_value, parameters.width) :
+				parameters.initial_value << (32 - parameters.width);
+	return *this;
+}
+
+Crc & Crc::update(const void * data, u32 size){
+	const u8 * bytes = static_cast<const u8*>(data);
+	if( (bytes == nullptr) || (size == 0) ){
+		return *this;
+	}
+
+#if defined SAPI_CRC_X86
+	if( (m_type == type_crc32c) && is_sse42_supported() ){
+		m_register = update_crc32c_sse42(m_register, bytes, size);
+		return *this;
+	}
+
+	if( (m_type == type_crc32) && (size >= 64) && is_pclmul_supported() ){
+		const u32 folded_size = size & ~0x0f;
+		m_register = update_crc32_pclmul(m_register, bytes, folded_size);
+		bytes += folded_size;
+		size -= folded_size;
+	}
+#endif
+
+	if( parameter_list[m_type].is_reflected ){
+		m_register = update_reflected(table(m_type).table, m_register, bytes, size);
+	} else {
+		m_register = update_normal(table(m_type).table, m_register, bytes, size);
+	}
+	return *this;
+}
+
+int Crc::update(
+		const fs::File & file,
+		fs::File::PageSize page_size
+		){
+	var::Data buffer(page_size.argument() ? page_size.argument() : 1024);
+	int total = 0;
+	int result;
+	while( (result = file.read(buffer.to_void(), fs::File::Size(buffer.size()))) > 0 ){
+		update(buffer.to_const_void(), result);
+		total += result;
+	}
+
+	if( result < 0 ){
+		return set_error_number_if_error(api::error_code_fs_failed_to_read);
+	}
+	return total;
+}
+
+u32 Crc::value() const {
+	const CrcParameters & parameters = parameter_list[m_type];
+	u32 result = parameters.is_reflected ?
+				m_register :
+				m_register >> (32 - parameters.width);
+	if( parameters.is_reflected && (parameters.width < 32) ){
+		result &= (1UL << parameters.width) - 1;
+	}
+	return result ^ parameters.final_xor;
+}
+
+u32 Crc::width(enum type type){
+	return type < type_total ? parameter_list[type].width : 0;
+}
+
+bool Crc::is_hardware_accelerated(enum type type){
+#if defined SAPI_CRC_X86
+	if( type == type_crc32c ){ return is_sse42_supported(); }
+	if( type == type_crc32 ){ return is_pclmul_supported(); }
+#else
+	MCU_UNUSED_ARGUMENT(type);
+#endif
+	return false;
+}
+
+u32 Crc::combine(
+		enum type type,
+		u32 first_value,
+		u32 second_value,
+		u32 second_size
+		){
+	if( type >= type_total ){ return 0; }
+	const CrcParameters & parameters = parameter_list[type];
+
+	/*
+	 * Feeding n zero bytes to the register is linear so
+	 * combined = second ^ zeros(first ^ final_xor ^ initial_value, second_size)
+	 * where zeros() is applied with matrix squaring in log(n) steps.
+	 *
+	 */
+	const u32 shift = 32 - parameters.width;
+	u32 value = first_value ^ parameters.final_xor ^ parameters.initial_value;
+	if( parameters.is_reflected == false ){
+		value <<= shift;
+	}
+
+	//operator for one zero byte
+	u32 odd[32];
+	u32 even[32];
+	const CrcTable & crc_table = table(type);
+	for(u32 i=0; i < 32; i++){
+		const u32 bit = 1UL << i;
+		odd[i] = parameters.is_reflected ?
+					(bit >> 8) ^ crc_table.table[0][bit & 0xff] :
+					(bit << 8) ^ crc_table.table[0][bit >> 24];
+	}
+
+	u32 * current = odd;
+	u32 * next = even;
+	u32 size = second_size;
+	while( 1 ){
+		if( size & 1 ){
+			value = gf2_matrix_times(current, value);
+		}
+		size >>= 1;
+		if( size == 0 ){ break; }
+		gf2_matrix_square(next, current);
+		u32 * swap = current;
+		current = next;
+		next = swap;
+	}
+
+	if( parameters.is_reflected == false ){
+		value >>= shift;
+	}
+	return value ^ second_value;
+}
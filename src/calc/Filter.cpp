@@ -3,6 +3,19 @@
 
 using namespace calc;
 
+namespace {
+
+//the single value and block versions share these so the results are identical
+
+inline float low_pass(float in, float present_value, float alpha){
+	return in * (alpha) + present_value * (1.0f - alpha);
+}
+
+inline float high_pass(float input, float last_input, float present_value, float r_value){
+	return input - r_value * last_input + present_value;
+}
+
+}
 
 HighPassFilterF32::HighPassFilterF32(float start, float r_value){
 	m_r_value = r_value;
@@ -19,15 +32,38 @@ void HighPassFilterF32::set_r_value(float r_value){
 }
 
 float HighPassFilterF32::calculate(float input){
-	m_present_value = input - m_r_value * m_last_input + m_present_value;
+	m_present_value = high_pass(input, m_last_input, m_present_value, m_r_value);
 	m_last_input = input;
 	return m_present_value;
 }
 
+void HighPassFilterF32::calculate(const float * input, float * output, u32 count){
+	float present_value = m_present_value;
+	float last_input = m_last_input;
+	const float r_value = m_r_value;
+	for(u32 i=0; i < count; i++){
+		const float value = input[i];
+		present_value = high_pass(value, last_input, present_value, r_value);
+		last_input = value;
+		output[i] = present_value;
+	}
+	m_present_value = present_value;
+	m_last_input = last_input;
+}
+
 LowPassFilterF32::LowPassFilterF32(float start, float alpha){ m_alpha = alpha; m_present_value = start; }
 
 float LowPassFilterF32::calculate(float in){
-	return (m_present_value = in * (m_alpha) + m_present_value * (1.0f - m_alpha));
+	return (m_present_value = low_pass(in, m_present_value, m_alpha));
+}
+
+void LowPassFilterF32::calculate(const float * input, float * output, u32 count){
+	float present_value = m_present_value;
+	const float alpha = m_alpha;
+	for(u32 i=0; i < count; i++){
+		output[i] = present_value = low_pass(input[i], present_value, alpha);
+	}
+	m_present_value = present_value;
 }
 
 void LowPassFilterF32::reset(float start){
@@ -38,3 +74,103 @@ float LowPassFilterF32::calculate_alpha(float sampling_frequency, float magnitud
 
 	return -1;
 }
+
+MultiChannelLowPassFilterF32::MultiChannelLowPassFilterF32(
+		u32 channel_count,
+		float start,
+		float alpha
+		) :
+	m_present_value(channel_count),
+	m_alpha(channel_count){
+	reset(start);
+	set_alpha(alpha);
+}
+
+void MultiChannelLowPassFilterF32::set_alpha(float value){
+	for(float & alpha: m_alpha){
+		alpha = value;
+	}
+}
+
+void MultiChannelLowPassFilterF32::set_alpha(u32 channel, float value){
+	m_alpha.at(channel) = value;
+}
+
+void MultiChannelLowPassFilterF32::reset(float start){
+	for(float & present_value: m_present_value){
+		present_value = start;
+	}
+}
+
+void MultiChannelLowPassFilterF32::calculate(
+		const float * input,
+		float * output,
+		u32 frame_count
+		){
+	const u32 channels = channel_count();
+	float * present_value = m_present_value.data();
+	const float * alpha = m_alpha.data();
+
+	//the channels are independent so the inner loop can use SIMD lanes
+	for(u32 frame=0; frame < frame_count; frame++){
+		const float * in = input + frame*channels;
+		float * out = output + frame*channels;
+		for(u32 channel=0; channel < channels; channel++){
+			const float value = low_pass(in[channel], present_value[channel], alpha[channel]);
+			present_value[channel] = value;
+			out[channel] = value;
+		}
+	}
+}
+
+MultiChannelHighPassFilterF32::MultiChannelHighPassFilterF32(
+		u32 channel_count,
+		float start,
+		float r_value
+		) :
+	m_present_value(channel_count),
+	m_last_input(channel_count),
+	m_r_value(channel_count){
+	reset(start);
+	set_r_value(r_value);
+}
+
+void MultiChannelHighPassFilterF32::reset(float start){
+	for(u32 channel=0; channel < channel_count(); channel++){
+		m_last_input.at(channel) = start;
+		m_present_value.at(channel) = 0.0f;
+	}
+}
+
+void MultiChannelHighPassFilterF32::set_r_value(float r_value){
+	for(float & value: m_r_value){
+		value = r_value;
+	}
+}
+
+void MultiChannelHighPassFilterF32::set_r_value(u32 channel, float r_value){
+	m_r_value.at(channel) = r_value;
+}
+
+void MultiChannelHighPassFilterF32::calculate(
+		const float * input,
+		float * output,
+		u32 frame_count
+		){
+	const u32 channels = channel_count();
+	float * present_value = m_present_value.data();
+	float * last_input = m_last_input.data();
+	const float * r_value = m_r_value.data();
+
+	for(u32 frame=0; frame < frame_count; frame++){
+		const float * in = input + frame*channels;
+		float * out = output + frame*channels;
+		for(u32 channel=0; channel < channels; channel++){
+			const float value = in[channel];
+			const float result = high_pass(value, last_input[channel], present_value[channel], r_value[channel]);
+			last_input[channel] = value;
+			present_value[channel] = result;
+			out[channel] = result;
+		}
+	}
+}
@@ -0,0 +1,142 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+#include "calc/Ema.hpp"
+#include "calc/Filter.hpp"
+#include "calc/FilterTest.hpp"
+
+using namespace calc;
+
+namespace {
+
+enum {
+	sample_count = 64
+};
+
+//memcmp() so -0.0 and 0.0 (or different NaNs) are not treated as equal
+template<typename T> bool is_identical(const T * a, const T * b, u32 count){
+	return memcmp(a, b, count * sizeof(T)) == 0;
+}
+
+}
+
+bool FilterTest::execute_class_api_case(){
+	//each check stops at its first failure but the others still run
+	execute_low_pass_f32_case();
+	execute_high_pass_f32_case();
+	execute_low_pass_s32_case();
+	execute_ema_case();
+	return case_result();
+}
+
+bool FilterTest::execute_low_pass_f32_case(){
+	float input[sample_count];
+	float expected[sample_count];
+	float output[sample_count];
+	float interleaved[sample_count*2];
+
+	for(u32 i=0; i < sample_count; i++){
+		input[i] = (i % 7) * 0.37f - 1.0f;
+		interleaved[i*2] = input[i];
+		interleaved[i*2+1] = input[i];
+	}
+
+	LowPassFilterF32 scalar_filter(0.5f, 0.2f);
+	for(u32 i=0; i < sample_count; i++){
+		expected[i] = scalar_filter.calculate(input[i]);
+	}
+
+	LowPassFilterF32 block_filter(0.5f, 0.2f);
+	block_filter.calculate(input, output, sample_count);
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	//the block can be filtered in place
+	memcpy(output, input, sizeof(output));
+	LowPassFilterF32 in_place_filter(0.5f, 0.2f);
+	in_place_filter.calculate(output, output, sample_count);
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	var::Ring<float> ring(sample_count*2);
+	for(u32 i=0; i < sample_count; i++){
+		ring.push(input[i]);
+	}
+	LowPassFilterF32 ring_filter(0.5f, 0.2f);
+	TEST_THIS_ASSERT(u32, ring_filter.calculate(ring, output, sample_count), static_cast<u32>(sample_count));
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	MultiChannelLowPassFilterF32 multi_filter(2, 0.5f, 0.2f);
+	multi_filter.calculate(interleaved, interleaved, sample_count);
+	for(u32 i=0; i < sample_count; i++){
+		TEST_THIS_ASSERT(bool, is_identical(expected + i, interleaved + i*2, 1), true);
+		TEST_THIS_ASSERT(bool, is_identical(expected + i, interleaved + i*2 + 1, 1), true);
+	}
+
+	return true;
+}
+
+bool FilterTest::execute_high_pass_f32_case(){
+	float input[sample_count];
+	float expected[sample_count];
+	float output[sample_count];
+
+	for(u32 i=0; i < sample_count; i++){
+		input[i] = (i % 5) * 0.61f - 1.0f;
+	}
+
+	HighPassFilterF32 scalar_filter(0.25f, 0.9f);
+	for(u32 i=0; i < sample_count; i++){
+		expected[i] = scalar_filter.calculate(input[i]);
+	}
+
+	HighPassFilterF32 block_filter(0.25f, 0.9f);
+	block_filter.calculate(input, output, sample_count);
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	MultiChannelHighPassFilterF32 multi_filter(1, 0.25f, 0.9f);
+	multi_filter.calculate(input, output, sample_count);
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	return true;
+}
+
+bool FilterTest::execute_low_pass_s32_case(){
+	s32 input[sample_count];
+	s32 expected[sample_count];
+	s32 output[sample_count];
+
+	for(u32 i=0; i < sample_count; i++){
+		input[i] = static_cast<s32>((i % 9) * 1000) - 4000;
+	}
+
+	LowPassFilterS32 scalar_filter(0, 8192);
+	for(u32 i=0; i < sample_count; i++){
+		expected[i] = scalar_filter.calculate(input[i]);
+	}
+
+	LowPassFilterS32 block_filter(0, 8192);
+	block_filter.calculate(input, output, sample_count);
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	return true;
+}
+
+bool FilterTest::execute_ema_case(){
+	float input[sample_count];
+	float expected[sample_count];
+	float output[sample_count];
+
+	for(u32 i=0; i < sample_count; i++){
+		input[i] = (i % 3) * 0.5f;
+	}
+
+	Ema_f scalar_ema(0.0f, 0.1f);
+	for(u32 i=0; i < sample_count; i++){
+		expected[i] = scalar_ema.calculate(input[i]);
+	}
+
+	Ema_f block_ema(0.0f, 0.1f);
+	block_ema.calculate(input, output, sample_count);
+	TEST_THIS_ASSERT(bool, is_identical(expected, output, sample_count), true);
+
+	return true;
+}
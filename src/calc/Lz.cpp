@@ -0,0 +1,625 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+#include "calc/Lz.hpp"
+
+using namespace calc;
+
+namespace {
+
+/*
+ * The LZ4 block format is a list of sequences:
+ *
+ * - token: high nibble is the literal count, low nibble is the match length minus 4
+ *   (15 means more bytes follow: each byte is added until one isn't 255)
+ * - the literals
+ * - match offset (2 bytes, little endian)
+ *
+ * The last sequence has only literals. The last match must start
+ * at least 12 bytes before the end and the last 5 bytes are
+ * always literals.
+ *
+ */
+const u32 min_match = 4;
+const u32 last_literals = 5;
+const u32 match_find_limit = 12;
+const u32 max_offset = 65535;
+
+#if defined __link
+//16 KB on the stack
+const u32 hash_log = 12;
+#else
+//1 KB on the stack
+const u32 hash_log = 8;
+#endif
+
+//higher values skip ahead sooner in data that doesn't compress
+const u32 skip_trigger = 6;
+
+inline u32 read32(const u8 * p){
+	u32 value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+inline u32 hash(u32 sequence){
+	return static_cast<u32>(sequence * 2654435761U) >> (32 - hash_log);
+}
+
+#if defined __link
+using word_t = u64;
+inline u32 count_trailing_zero_bytes(u64 value){
+	return __builtin_ctzll(value) >> 3;
+}
+#else
+using word_t = u32;
+inline u32 count_trailing_zero_bytes(u32 value){
+	return __builtin_ctz(value) >> 3;
+}
+#endif
+
+//returns the number of bytes that match (a word at a time)
+inline u32 count_match(const u8 * p, const u8 * match, const u8 * limit){
+	const u8 * start = p;
+	while( p + sizeof(word_t) <= limit ){
+		word_t a;
+		word_t b;
+		memcpy(&a, p, sizeof(a));
+		memcpy(&b, match, sizeof(b));
+		const word_t difference = a ^ b;
+		if( difference ){
+			return (p - start) + count_trailing_zero_bytes(difference);
+		}
+		p += sizeof(word_t);
+		match += sizeof(word_t);
+	}
+
+	while( (p < limit) && (*p == *match) ){
+		p++;
+		match++;
+	}
+	return p - start;
+}
+
+inline u8 * write_length(u8 * output, u32 length){
+	while( length >= 255 ){
+		*output++ = 255;
+		length -= 255;
+	}
+	*output++ = static_cast<u8>(length);
+	return output;
+}
+
+//worst case bytes needed for a sequence
+inline u32 sequence_bound(u32 literal_count, u32 match_length){
+	return 1 + literal_count/255 + 1 + literal_count + 2 + match_length/255 + 1;
+}
+
+}
+
+int Lz::compress(
+		void * dest,
+		u32 dest_size,
+		const void * src,
+		u32 src_size
+		){
+	const u8 * const input = static_cast<const u8*>(src);
+	const u8 * const input_end = input + src_size;
+	u8 * output = static_cast<u8*>(dest);
+	u8 * const output_end = output + dest_size;
+	const u8 * anchor = input;
+
+	if( src_size >= match_find_limit + 1 ){
+		u32 table[1 << hash_log];
+		memset(table, 0, sizeof(table));
+
+		const u8 * const match_limit = input_end - last_literals;
+		const u8 * const find_limit = input_end - match_find_limit;
+		const u8 * p = input + 1;
+
+		while( p <= find_limit ){
+			//find a match
+			const u8 * match;
+			u32 search_count = 1 << skip_trigger;
+			bool is_found = false;
+			while( p <= find_limit ){
+				const u32 sequence = read32(p);
+				const u32 h = hash(sequence);
+				match = input + table[h];
+				table[h] = p - input;
+				if( (match < p) &&
+						(static_cast<u32>(p - match) <= max_offset) &&
+						(read32(match) == sequence) ){
+					is_found = true;
+					break;
+				}
+				p += search_count++ >> skip_trigger;
+			}
+
+			if( is_found == false ){
+				break;
+			}
+
+			//extend backwards over the literals
+			while( (p > anchor) && (match > input) && (p[-1] == match[-1]) ){
+				p--;
+				match--;
+			}
+
+			const u32 literal_count = p - anchor;
+			const u32 match_length = min_match + count_match(
+						p + min_match,
+						match + min_match,
+						match_limit
+						);
+
+			if( output + sequence_bound(literal_count, match_length) > output_end ){
+				return -1;
+			}
+
+			u8 * token = output++;
+			if( literal_count >= 15 ){
+				*token = 15 << 4;
+				output = write_length(output, literal_count - 15);
+			} else {
+				*token = literal_count << 4;
+			}
+			memcpy(output, anchor, literal_count);
+			output += literal_count;
+
+			const u32 offset = p - match;
+			*output++ = offset;
+			*output++ = offset >> 8;
+
+			if( match_length - min_match >= 15 ){
+				*token |= 15;
+				output = write_length(output, match_length - min_match - 15);
+			} else {
+				*token |= match_length - min_match;
+			}
+
+			p += match_length;
+			anchor = p;
+
+			if( p <= find_limit ){
+				//the positions inside the match are not added (faster)
+				table[hash(read32(p - 2))] = p - 2 - input;
+			}
+		}
+	}
+
+	//the rest is literals
+	const u32 literal_count = input_end - anchor;
+	if( output + 1 + literal_count/255 + 1 + literal_count > output_end ){
+		return -1;
+	}
+
+	if( literal_count >= 15 ){
+		*output++ = 15 << 4;
+		output = write_length(output, literal_count - 15);
+	} else {
+		*output++ = literal_count << 4;
+	}
+	memcpy(output, anchor, literal_count);
+	output += literal_count;
+
+	return output - static_cast<u8*>(dest);
+}
+
+int Lz::decompress(
+		void * dest,
+		u32 dest_size,
+		const void * src,
+		u32 src_size
+		){
+	const u8 * input = static_cast<const u8*>(src);
+	const u8 * const input_end = input + src_size;
+	u8 * const output_start = static_cast<u8*>(dest);
+	u8 * output = output_start;
+	u8 * const output_end = output + dest_size;
+
+	if( src_size == 0 ){
+		return -1;
+	}
+
+	while( 1 ){
+		const u32 token = *input++;
+
+		u32 literal_count = token >> 4;
+		if( literal_count == 15 ){
+			u32 value;
+			do {
+				if( input == input_end ){ return -1; }
+				value = *input++;
+				literal_count += value;
+			} while( value == 255 );
+		}
+
+		if( (literal_count > static_cast<u32>(input_end - input)) ||
+				(literal_count > static_cast<u32>(output_end - output)) ){
+			return -1;
+		}
+
+		if( (literal_count <= 16) &&
+				(input_end - input >= 16) &&
+				(output_end - output >= 16) ){
+			//a fixed size copy is much faster for short literals
+			memcpy(output, input, 16);
+		} else if( literal_count ){
+			memcpy(output, input, literal_count);
+		}
+		output += literal_count;
+		input += literal_count;
+
+		if( input == input_end ){
+			//the last sequence has no match
+			break;
+		}
+
+		if( input_end - input < 2 ){
+			return -1;
+		}
+
+		const u32 offset = input[0] | (input[1] << 8);
+		input += 2;
+		if( (offset == 0) || (offset > static_cast<u32>(output - output_start)) ){
+			return -1;
+		}
+
+		u32 match_length = token & 0x0f;
+		if( match_length == 15 ){
+			u32 value;
+			do {
+				if( input == input_end ){ return -1; }
+				value = *input++;
+				match_length += value;
+			} while( value == 255 );
+		}
+		match_length += min_match;
+
+		if( match_length > static_cast<u32>(output_end - output) ){
+			return -1;
+		}
+
+		const u8 * match = output - offset;
+		if( output + match_length + 8 <= output_end ){
+			//copy 8 bytes at a time (may copy up to 7 extra bytes)
+			u8 * const end = output + match_length;
+			if( offset < 8 ){
+				//repeat the pattern until the copy doesn't overlap
+				for(u32 i=0; i < 8; i++){
+					output[i] = match[i];
+				}
+				output += 8;
+				match = output - offset * ((8 + offset - 1) / offset);
+			}
+
+			while( output < end ){
+				memcpy(output, match, 8);
+				output += 8;
+				match += 8;
+			}
+			output = end;
+		} else {
+			//overlapping matches repeat the last offset bytes
+			for(u32 i=0; i < match_length; i++){
+				output[i] = match[i];
+			}
+			output += match_length;
+		}
+
+		if( input == input_end ){
+			return -1;
+		}
+	}
+
+	return output - output_start;
+}
+
+var::Data Lz::compress(const var::Reference & input){
+	var::Data result(calc_bound(input.size()));
+	if( result.size() != calc_bound(input.size()) ){
+		return var::Data();
+	}
+
+	int size = compress(
+				result.to_void(),
+				result.size(),
+				input.to_const_void(),
+				input.size()
+				);
+
+	if( size < 0 ){
+		return var::Data();
+	}
+
+	result.resize(size);
+	return result;
+}
+
+var::Data Lz::decompress(
+		const var::Reference & input,
+		Size size
+		){
+	var::Data result(size.argument());
+	if( result.size() != size.argument() ){
+		return var::Data();
+	}
+
+	int result_size = decompress(
+				result.to_void(),
+				result.size(),
+				input.to_const_void(),
+				input.size()
+				);
+
+	if( result_size < 0 ){
+		return var::Data();
+	}
+
+	result.resize(result_size);
+	return result;
+}
+
+namespace {
+
+const u8 stream_magic[4] = { 'S', 'L', 'Z', '1' };
+
+inline void write_u32(u8 * p, u32 value){
+	p[0] = value;
+	p[1] = value >> 8;
+	p[2] = value >> 16;
+	p[3] = value >> 24;
+}
+
+inline u32 read_u32(const u8 * p){
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<u32>(p[3]) << 24);
+}
+
+}
+
+LzFile::LzFile(
+		const fs::File & file,
+		Size block_size
+		) : m_file(file), m_block_size(block_size.argument()){
+	if( m_block_size == 0 ){
+		m_block_size = SAPI_LZ_DEFAULT_BLOCK_SIZE;
+	} else if( m_block_size > SAPI_LZ_MAXIMUM_BLOCK_SIZE ){
+		m_block_size = SAPI_LZ_MAXIMUM_BLOCK_SIZE;
+	}
+	m_fd = 0;
+}
+
+int LzFile::write_underlying(const void * buf, u32 nbyte) const {
+	if( m_file.write(buf, Size(nbyte)) != static_cast<int>(nbyte) ){
+		return set_error_number_if_error(api::error_code_fs_failed_to_write);
+	}
+	m_compressed_size += nbyte;
+	return 0;
+}
+
+int LzFile::read_underlying(void * buf, u32 nbyte) const {
+	u8 * destination = static_cast<u8*>(buf);
+	u32 bytes_read = 0;
+	while( bytes_read < nbyte ){
+		int result = m_file.read(destination + bytes_read, Size(nbyte - bytes_read));
+		if( result < 0 ){
+			return set_error_number_if_error(api::error_code_fs_failed_to_read);
+		}
+		if( result == 0 ){
+			break;
+		}
+		bytes_read += result;
+	}
+	m_compressed_size += bytes_read;
+	return bytes_read;
+}
+
+int LzFile::start_write() const {
+	m_block.resize(m_block_size);
+	m_compressed_block.resize(header_size + Lz::calc_bound(m_block_size));
+	if( (m_block.size() != m_block_size) ||
+			(m_compressed_block.size() != header_size + Lz::calc_bound(m_block_size)) ){
+		return set_error_number_if_error(-1);
+	}
+
+	u8 header[8];
+	memcpy(header, stream_magic, sizeof(stream_magic));
+	write_u32(header + 4, m_block_size);
+	m_mode = mode_write;
+	m_tail = 0;
+	return write_underlying(header, sizeof(header));
+}
+
+int LzFile::flush() const {
+	if( (m_mode != mode_write) || (m_tail == 0) ){
+		return 0;
+	}
+
+	u8 * block = m_compressed_block.to_u8();
+	int size = Lz::compress(
+				block + header_size,
+				m_compressed_block.size() - header_size,
+				m_block.to_const_void(),
+				m_tail
+				);
+
+	if( (size < 0) || (static_cast<u32>(size) >= m_tail) ){
+		//store data that doesn't get smaller
+		memcpy(block + header_size, m_block.to_const_void(), m_tail);
+		size = m_tail;
+		write_u32(block, size | stored_flag);
+	} else {
+		write_u32(block, size);
+	}
+
+	m_tail = 0;
+	return write_underlying(block, header_size + size);
+}
+
+int LzFile::write(
+		const void * buf,
+		Size nbyte
+		) const {
+	if( m_mode == mode_none ){
+		if( start_write() < 0 ){
+			return -1;
+		}
+	} else if( m_mode != mode_write ){
+		return set_error_number_if_error(api::error_code_fs_cant_write);
+	}
+
+	const u8 * source = static_cast<const u8*>(buf);
+	u32 bytes_written = 0;
+	while( bytes_written < nbyte.argument() ){
+		u32 page_size = m_block_size - m_tail;
+		if( page_size > nbyte.argument() - bytes_written ){
+			page_size = nbyte.argument() - bytes_written;
+		}
+		memcpy(m_block.to_u8() + m_tail, source + bytes_written, page_size);
+		m_tail += page_size;
+		bytes_written += page_size;
+
+		if( m_tail == m_block_size ){
+			if( flush() < 0 ){
+				return -1;
+			}
+		}
+	}
+
+	m_uncompressed_size += bytes_written;
+	return bytes_written;
+}
+
+int LzFile::close(){
+	if( m_mode == mode_write ){
+		const u8 end_mark[header_size] = {0};
+		int result = flush();
+		m_mode = mode_end;
+		if( (result < 0) || (write_underlying(end_mark, header_size) < 0) ){
+			return -1;
+		}
+	}
+	m_mode = mode_end;
+	return 0;
+}
+
+int LzFile::start_read() const {
+	u8 header[8];
+	int result = read_underlying(header, sizeof(header));
+	if( result == 0 ){
+		//an empty file is an empty stream
+		m_mode = mode_end;
+		return 0;
+	}
+
+	if( (result != sizeof(header)) ||
+			memcmp(header, stream_magic, sizeof(stream_magic)) ){
+		return set_error_number_if_error(api::error_code_calc_lz_bad_format);
+	}
+
+	//check the size before allocating so a corrupt header can't ask for gigabytes
+	m_block_size = read_u32(header + 4);
+	if( (m_block_size == 0) ||
+			(m_block_size > SAPI_LZ_MAXIMUM_BLOCK_SIZE) ){
+		return set_error_number_if_error(api::error_code_calc_lz_bad_format);
+	}
+
+	m_block.resize(m_block_size);
+	m_compressed_block.resize(Lz::calc_bound(m_block_size));
+	if( (m_block.size() != m_block_size) ||
+			(m_compressed_block.size() != Lz::calc_bound(m_block_size)) ){
+		return set_error_number_if_error(api::error_code_calc_lz_bad_format);
+	}
+
+	m_mode = mode_read;
+	m_head = 0;
+	m_tail = 0;
+	return 0;
+}
+
+int LzFile::read_block() const {
+	u8 header[header_size];
+	if( read_underlying(header, header_size) != header_size ){
+		return set_error_number_if_error(api::error_code_calc_lz_bad_format);
+	}
+
+	const u32 value = read_u32(header);
+	if( value == 0 ){
+		m_mode = mode_end;
+		return 0;
+	}
+
+	const u32 size = value & ~stored_flag;
+	m_head = 0;
+	m_tail = 0;
+
+	if( value & stored_flag ){
+		if( (size > m_block_size) ||
+				(read_underlying(m_block.to_void(), size) != static_cast<int>(size)) ){
+			return set_error_number_if_error(api::error_code_calc_lz_corrupt_block);
+		}
+		m_tail = size;
+		return size;
+	}
+
+	if( (size > m_compressed_block.size()) ||
+			(read_underlying(m_compressed_block.to_void(), size) != static_cast<int>(size)) ){
+		return set_error_number_if_error(api::error_code_calc_lz_corrupt_block);
+	}
+
+	int result = Lz::decompress(
+				m_block.to_void(),
+				m_block_size,
+				m_compressed_block.to_const_void(),
+				size
+				);
+	if( result < 0 ){
+		return set_error_number_if_error(api::error_code_calc_lz_corrupt_block);
+	}
+
+	m_tail = result;
+	return result;
+}
+
+int LzFile::read(
+		void * buf,
+		Size nbyte
+		) const {
+	if( m_mode == mode_none ){
+		if( start_read() < 0 ){
+			return -1;
+		}
+	} else if( m_mode == mode_write ){
+		return set_error_number_if_error(api::error_code_fs_cant_read);
+	}
+
+	u8 * destination = static_cast<u8*>(buf);
+	u32 bytes_read = 0;
+	while( bytes_read < nbyte.argument() ){
+		if( m_head == m_tail ){
+			if( m_mode != mode_read ){
+				break;
+			}
+
+			int result = read_block();
+			if( result < 0 ){
+				m_mode = mode_end;
+				if( bytes_read == 0 ){ return result; }
+				break;
+			}
+			continue;
+		}
+
+		u32 page_size = m_tail - m_head;
+		if( page_size > nbyte.argument() - bytes_read ){
+			page_size = nbyte.argument() - bytes_read;
+		}
+		memcpy(destination + bytes_read, m_block.to_const_u8() + m_head, page_size);
+		m_head += page_size;
+		bytes_read += page_size;
+	}
+
+	m_uncompressed_size += bytes_read;
+	return bytes_read;
+}
@@ -2,6 +2,7 @@
 //Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc
 
 #include <cstdio>
+#include <cstring>
 #include "calc/Rle.hpp"
 using namespace calc;
 
@@ -9,63 +10,84 @@ using namespace calc;
 Rle::Rle(){}
 
 
-int Rle::calc_size(const void * src, int nbyte){
-	int bp; //bytes processed
-	uint8_t size;
-	int next_dest_size;
-	const uint8_t * srcp = (const uint8_t*)src;
-	next_dest_size = 0;
-	bp = 0;
-	do {
-		size = 1;
-		bp++;
-		srcp++;
-		while( (size != 255) &&
-				 (bp < nbyte) &&
-				 (*(srcp-1) == *(srcp)) ){
-			size++;
-			bp++;
-			srcp++;
+namespace {
+
+#if defined __link
+using word_t = u64;
+inline u32 count_trailing_zero_bytes(u64 value){
+	return __builtin_ctzll(value) >> 3;
+}
+#else
+using word_t = u32;
+inline u32 count_trailing_zero_bytes(u32 value){
+	return __builtin_ctz(value) >> 3;
+}
+#endif
+
+//returns the length of the run at src (up to max) comparing a word at a time
+inline u32 run_length(const u8 * src, u32 max){
+	const u8 value = src[0];
+	u32 size = 1;
+
+	if( (max > 1) && (src[1] != value) ){
+		//most runs are short
+		return 1;
+	}
+
+	const word_t pattern = value * (static_cast<word_t>(-1) / 0xff);
+	while( size + sizeof(word_t) <= max ){
+		word_t word;
+		memcpy(&word, src + size, sizeof(word));
+		const word_t difference = word ^ pattern;
+		if( difference ){
+			return size + count_trailing_zero_bytes(difference);
 		}
-		next_dest_size += sizeof(element_t);
+		size += sizeof(word_t);
+	}
+
+	while( (size < max) && (src[size] == value) ){
+		size++;
+	}
+	return size;
+}
+
+}
 
-	} while(bp < nbyte);
+int Rle::calc_size(const void * src, int nbyte){
+	const u8 * srcp = static_cast<const u8*>(src);
+	int next_dest_size = 0;
+	int bp = 0; //bytes processed
+	while( bp < nbyte ){
+		u32 max = nbyte - bp;
+		if( max > 255 ){ max = 255; }
+		bp += run_length(srcp + bp, max);
+		next_dest_size += sizeof(element_t);
+	}
 	return next_dest_size;
 }
 
 int Rle::encode(void * dest, s32 & dest_size, const void * src, s32 src_size){
-	int bp; //bytes processed
-	uint8_t value;
-	uint8_t size;
-	int next_dest_size;
-	const uint8_t * srcp = (const uint8_t*)src;
-	element_t * elements = (element_t*)dest;
-
-	next_dest_size = 0;
-	bp = 0;
-	do {
+	const u8 * srcp = static_cast<const u8*>(src);
+	element_t * elements = static_cast<element_t*>(dest);
+	int next_dest_size = 0;
+	int bp = 0; //bytes processed
+
+	while( bp < src_size ){
 		if( next_dest_size + (int)sizeof(element_t) > dest_size ){
-			dest_size = next_dest_size;
-			return bp;
+			break;
 		}
 
-		size = 1;
-		bp++;
-		value = *srcp++;
-		while( (size != 255) &&
-				 (bp < src_size) &&
-				 (*(srcp-1) == *(srcp)) ){
-			size++;
-			bp++;
-			srcp++;
-		}
+		u32 max = src_size - bp;
+		if( max > 255 ){ max = 255; }
+		const u32 size = run_length(srcp + bp, max);
 
-		elements->data = value;
+		elements->data = srcp[bp];
 		elements->size = size;
 		elements++;
 		next_dest_size += sizeof(element_t);
+		bp += size;
+	}
 
-	} while(bp < src_size);
 	dest_size = next_dest_size;
 	return bp;
 }
@@ -4,42 +4,24 @@ using namespace fmt;
 
 Csv::Csv(fs::File& file, const var::String & delimeters) :
 	m_file(file),
-	m_delimeters(delimeters){
+	m_reader(file, CsvReader::Options().set_delimeters(delimeters)){
 	m_header = read_line(true);
 }
 
 var::StringList Csv::read_line(bool is_header){
 	var::StringList result;
 
-	var::String line = m_file.gets();
-	for(u32 i=0; i < line.length(); i++){
-		if( (u8)line.at(i) > 127 ){
-			line.erase(
-						var::String::Position(i),
-						var::String::Length(1)
-						);
-			i--;
-		}
+	if( m_reader.read_row() <= 0 ){
+		return result;
 	}
 
-	line
-			.replace(
-				var::String::ToErase("\n"),
-				var::String::ToInsert("")
-				)
-			.replace(
-				var::String::ToErase("\r"),
-				var::String::ToInsert("")
-				);
-
-	if( line.length() == 0 ){
-		return result;
+	result = m_reader.row().to_string_list();
+	for(var::String & field: result){
+		//drop non-ASCII characters
+		field.erase_if([](char c){
+			return static_cast<u8>(c) > 127;
+		});
 	}
-	result = var::Tokenizer(
-				line,
-				var::Tokenizer::Delimeters(m_delimeters),
-				var::Tokenizer::IgnoreBetween("\"")
-				).list();
 
 	if( !is_header ){
 		if( (result.count() > 0) && (result.count() != header().count()) ){
@@ -55,18 +37,20 @@ var::Matrix<var::String> Csv::load(
 		){
 	var::Matrix<var::String> result;
 
-	fs::DataFile data_file = fs::DataFile(
-				fs::File::Path(file_path)
-				);
+	fs::File file;
+	if( file.open(file_path, fs::OpenFlags::read_only()) < 0 ){
+		return result;
+	}
 
-	Csv csv(data_file, delimeters.argument());
+	Csv csv(file, delimeters.argument());
 
 	var::StringList row;
 	result.append( csv.header() );
 	do {
 		row = csv.read_line();
 		if( row.count() > 0 ){
-			result.append( row );
+			//the values are moved in to the matrix's single buffer
+			result.append( std::move(row) );
 		}
 	} while( row.count() > 0 );
 
@@ -79,5 +63,23 @@ int Csv::save(
 		Delimeters delimeters
 		){
 
-	return 0;
+	fs::File file;
+	int result = file.create(file_path, fs::File::IsOverwrite(true));
+	if( result < 0 ){
+		return result;
+	}
+
+	CsvWriter writer(
+				file,
+				CsvWriter::Options().set_delimeter(delimeter(delimeters.argument()))
+				);
+
+	for(const auto & row: m_matrix){
+		result = writer.write_row(row);
+		if( result < 0 ){
+			return result;
+		}
+	}
+
+	return writer.flush();
 }
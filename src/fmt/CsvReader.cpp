@@ -0,0 +1,271 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstdlib>
+#include <cstring>
+#include "fmt/CsvReader.hpp"
+
+using namespace fmt;
+
+s32 CsvReader::Row::to_integer(u32 offset) const {
+	const var::StringView value = at(offset);
+	if( value.is_empty() ){ return 0; }
+	return ::strtol(value.data(), nullptr, 10);
+}
+
+float CsvReader::Row::to_float(u32 offset) const {
+	const var::StringView value = at(offset);
+	if( value.is_empty() ){ return 0.0f; }
+	return ::strtof(value.data(), nullptr);
+}
+
+var::StringList CsvReader::Row::to_string_list() const {
+	var::StringList result;
+	result.reserve(count());
+	for(const var::StringView & field: m_field_list){
+		result.push_back(field.to_string());
+	}
+	return result;
+}
+
+CsvReader::CsvReader(
+		const fs::File & file,
+		const Options & options
+		) :
+	m_file(
+		file,
+		fs::File::Size(options.buffer_size() > 0 ? options.buffer_size() : 512)
+		),
+	m_options(options){
+
+	if( options.delimeters().is_empty() ){
+		m_delimeter_set.add(options.delimeter());
+	} else {
+		m_delimeter_set.add(var::StringView(options.delimeters()));
+	}
+
+	m_special_set
+			.add(m_delimeter_set)
+			.add(options.quote())
+			.add('\r')
+			.add('\n');
+}
+
+int CsvReader::fill_buffer(){
+	//don't read again after the end (a pipe would block)
+	if( m_is_end_of_file ){
+		return 0;
+	}
+
+	int result = m_file.fill();
+	if( result < 0 ){
+		return set_error_number_if_error(api::error_code_fs_failed_to_read);
+	}
+
+	if( result == 0 ){
+		m_is_end_of_file = true;
+	}
+
+	return result;
+}
+
+void CsvReader::end_field(){
+	//the terminator lets the numeric conversions use the field in place
+	m_record.append('\0');
+	m_field_offset_list.push_back(m_record.length());
+}
+
+int CsvReader::read_row(){
+	enum {
+		state_field_start,
+		state_unquoted,
+		state_quoted,
+		state_quote_pending
+	} state = state_field_start;
+
+	const char quote = m_options.quote();
+	bool is_row_started = false;
+
+	m_record.clear();
+	m_field_offset_list.clear();
+	m_row.m_field_list.clear();
+
+	while( 1 ){
+		if( m_file.available() == 0 ){
+			int result = fill_buffer();
+			if( result < 0 ){
+				return result;
+			}
+
+			if( result == 0 ){
+				if( state == state_quoted ){
+					set_error_number(api::error_code_fmt_csv_unterminated_quote);
+					return api::error_code_fmt_csv_unterminated_quote;
+				}
+				if( is_row_started == false ){
+					return 0;
+				}
+				end_field();
+				break;
+			}
+		}
+
+		const char * buffer = m_file.buffered_data();
+		const u32 available = m_file.available();
+
+		if( state == state_quoted ){
+			//copy up to the next quote
+			const char * end = static_cast<const char*>(
+						memchr(buffer, quote, available)
+						);
+			if( end == nullptr ){
+				m_record.string().append(buffer, available);
+				m_file.advance(available);
+			} else {
+				m_record.string().append(buffer, end - buffer);
+				m_file.advance(end - buffer + 1);
+				state = state_quote_pending;
+			}
+			continue;
+		}
+
+		const char c = buffer[0];
+
+		if( state == state_quote_pending ){
+			state = state_unquoted;
+			if( c == quote ){
+				//a doubled quote is a quote in the value
+				m_record.append(quote);
+				m_file.advance(1);
+				state = state_quoted;
+				continue;
+			}
+		}
+
+		if( state == state_field_start ){
+			state = state_unquoted;
+			if( c == quote ){
+				is_row_started = true;
+				m_file.advance(1);
+				state = state_quoted;
+				continue;
+			}
+		}
+
+		//copy up to the next delimiter, quote or line ending
+		const size_t position = m_special_set.find(
+					var::StringView(buffer, available)
+					);
+
+		if( position == var::CharacterSet::npos ){
+			m_record.string().append(buffer, available);
+			m_file.advance(available);
+			is_row_started = true;
+			continue;
+		}
+
+		if( position > 0 ){
+			m_record.string().append(buffer, position);
+			is_row_started = true;
+		}
+
+		const char special = buffer[position];
+		m_file.advance(position + 1);
+		if( m_delimeter_set.contains(special) ){
+			end_field();
+			is_row_started = true;
+			state = state_field_start;
+		} else if( special == '\n' ){
+			if( is_row_started ){
+				end_field();
+				break;
+			}
+			//skip empty lines
+			state = state_field_start;
+		} else if( special == quote ){
+			//quotes in the middle of an unquoted value are kept
+			m_record.append(quote);
+			is_row_started = true;
+		}
+		//'\r' is dropped
+	}
+
+	//the record won't change until the next row is read
+	u32 start = 0;
+	m_row.m_field_list.reserve(m_field_offset_list.count());
+	for(u32 end: m_field_offset_list){
+		m_row.m_field_list.push_back(
+					var::StringView(m_record.cstring() + start, end - start - 1)
+					);
+		start = end;
+	}
+
+	m_row_count++;
+	return m_row.count();
+}
+
+int CsvReader::read_header(){
+	int result = read_row();
+	if( result < 0 ){
+		return result;
+	}
+	m_header = m_row.to_string_list();
+	return m_header.count();
+}
+
+u32 CsvReader::column_offset(const var::StringView & name) const {
+	for(u32 i=0; i < m_header.count(); i++){
+		if( var::StringView(m_header.at(i)) == name ){
+			return i;
+		}
+	}
+	return m_header.count();
+}
+
+int CsvReader::read_columns(const var::Vector<Column> & column_list){
+	var::Vector<u32> offset_list;
+	offset_list.reserve(column_list.count());
+	for(const Column & column: column_list){
+		if( column.name().is_empty() ){
+			offset_list.push_back(column.offset());
+		} else {
+			const u32 offset = column_offset(column.name());
+			if( offset == m_header.count() ){
+				set_error_number(api::error_code_fmt_csv_column_not_found);
+				return api::error_code_fmt_csv_column_not_found;
+			}
+			offset_list.push_back(offset);
+		}
+	}
+
+	int result;
+	u32 count = 0;
+	while( (result = read_row()) > 0 ){
+		for(u32 i=0; i < column_list.count(); i++){
+			const Column & column = column_list.at(i);
+			const u32 offset = offset_list.at(i);
+			switch(column.type()){
+				case Column::type_integer:
+					static_cast<var::Vector<s32>*>(column.m_destination)->push_back(
+								m_row.to_integer(offset)
+								);
+					break;
+				case Column::type_real:
+					static_cast<var::Vector<float>*>(column.m_destination)->push_back(
+								m_row.to_float(offset)
+								);
+					break;
+				case Column::type_string:
+					static_cast<var::StringList*>(column.m_destination)->push_back(
+								m_row.at(offset).to_string()
+								);
+					break;
+			}
+		}
+		count++;
+	}
+
+	if( result < 0 ){
+		return result;
+	}
+	return count;
+}
@@ -0,0 +1,137 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstdio>
+#include <cstring>
+#include "fmt/CsvWriter.hpp"
+
+using namespace fmt;
+
+CsvWriter::CsvWriter(
+		const fs::File & file,
+		const Options & options
+		) :
+	m_file(file),
+	m_options(options),
+	m_buffer(options.buffer_size() > 0 ? options.buffer_size() : 512){
+
+	m_quote_set
+			.add(options.delimeter())
+			.add(options.quote())
+			.add('\r')
+			.add('\n');
+}
+
+CsvWriter::~CsvWriter(){
+	flush();
+}
+
+int CsvWriter::flush(){
+	if( m_size == 0 ){
+		return 0;
+	}
+
+	const u32 size = m_size;
+	m_size = 0;
+	if( m_file.write(m_buffer.to_const_void(), fs::File::Size(size)) != static_cast<int>(size) ){
+		return set_error_number_if_error(api::error_code_fs_failed_to_write);
+	}
+	return 0;
+}
+
+int CsvWriter::write(const char * data, u32 size){
+	if( m_size + size > m_buffer.size() ){
+		if( flush() < 0 ){
+			return -1;
+		}
+
+		if( size > m_buffer.size() ){
+			//too big for the buffer -- write directly
+			if( m_file.write(data, fs::File::Size(size)) != static_cast<int>(size) ){
+				return set_error_number_if_error(api::error_code_fs_failed_to_write);
+			}
+			return 0;
+		}
+	}
+
+	memcpy(m_buffer.to_char() + m_size, data, size);
+	m_size += size;
+	return 0;
+}
+
+int CsvWriter::write_unquoted_field(const char * data, u32 size){
+	if( m_is_row_started ){
+		const char delimeter = m_options.delimeter();
+		if( write(&delimeter, 1) < 0 ){
+			return -1;
+		}
+	}
+	m_is_row_started = true;
+	return write(data, size);
+}
+
+int CsvWriter::write_field(const var::StringView & value){
+	if( m_quote_set.find(value) == var::CharacterSet::npos ){
+		return write_unquoted_field(value.data(), value.length());
+	}
+
+	//quote the value and double any quotes in it
+	const char quote = m_options.quote();
+	if( write_unquoted_field(&quote, 1) < 0 ){
+		return -1;
+	}
+
+	size_t start = 0;
+	size_t position;
+	while( (position = value.find(quote, start)) != var::StringView::npos ){
+		if( (write(value.data() + start, position - start + 1) < 0) ||
+				(write(&quote, 1) < 0) ){
+			return -1;
+		}
+		start = position + 1;
+	}
+
+	if( (write(value.data() + start, value.length() - start) < 0) ||
+			(write(&quote, 1) < 0) ){
+		return -1;
+	}
+	return 0;
+}
+
+int CsvWriter::write_field(s32 value){
+	char buffer[16];
+	const int length = snprintf(buffer, sizeof(buffer), "%ld", static_cast<long>(value));
+	return write_unquoted_field(buffer, length);
+}
+
+int CsvWriter::write_field(float value){
+	char buffer[32];
+	const int length = snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(value));
+	return write_unquoted_field(buffer, length);
+}
+
+int CsvWriter::end_row(){
+	m_is_row_started = false;
+	m_row_count++;
+	return write(
+				m_options.line_ending().cstring(),
+				m_options.line_ending().length()
+				);
+}
+
+int CsvWriter::write_row(const var::StringList & row){
+	for(const var::String & field: row){
+		if( write_field(field) < 0 ){
+			return -1;
+		}
+	}
+	return end_row();
+}
+
+int CsvWriter::write_row(const var::Matrix<var::String>::ConstRow & row){
+	for(const var::String & field: row){
+		if( write_field(field) < 0 ){
+			return -1;
+		}
+	}
+	return end_row();
+}
@@ -5,9 +5,12 @@
 #include <cstdio>
 #include <cstring>
 #include <fcntl.h>
+#include <pthread.h>
+#include <vector>
 
 #include "fs/File.hpp"
 #include "sys/Link.hpp"
+#include "sys/Thread.hpp"
 #include "chrono/Timer.hpp"
 
 using namespace fs;
@@ -701,11 +704,16 @@ int File::write(
 int File::write(
 		const File& source_file,
 		const WriteOptions & options
-		){
+		) const {
 
 	if( options.location() != static_cast<u32>(-1) ){
 		seek(options.location(), whence_set);
 	}
+
+	if( options.is_pipelined() && (options.pipeline_depth() > 1) ){
+		return write_pipelined(source_file, options);
+	}
+
 	return write(
 				source_file,
 				PageSize(options.page_size()),
@@ -792,6 +800,266 @@ int File::write(
 	return set_error_number_if_error(static_cast<int>(size_processed));
 }
 
+namespace {
+
+/*! \cond */
+//pages are passed from the reader thread to the writer using a bounded ring
+class FilePipeline {
+public:
+	FilePipeline(
+			const File & source_file,
+			u32 depth,
+			u32 page_size,
+			u32 file_size
+			) : m_source_file(source_file){
+		m_page_size = page_size;
+		m_file_size = file_size;
+		m_page_list.resize(depth);
+		m_size_list.resize(depth);
+		for(u32 i=0; i < depth; i++){
+			m_page_list.at(i).resize(page_size);
+		}
+		pthread_mutex_init(&m_mutex, nullptr);
+		pthread_cond_init(&m_cond, nullptr);
+	}
+
+	~FilePipeline(){
+		pthread_cond_destroy(&m_cond);
+		pthread_mutex_destroy(&m_mutex);
+	}
+
+	bool is_valid() const {
+		for(const var::Data & page: m_page_list){
+			if( page.size() != m_page_size ){ return false; }
+		}
+		return m_page_list.size() > 0;
+	}
+
+	static void * read_source_file(void * args){
+		return static_cast<FilePipeline*>(args)->read_source_file();
+	}
+
+	//returns the number of bytes in the page or <= 0 when there is nothing left
+	int acquire_page(const var::Data *& page){
+		pthread_mutex_lock(&m_mutex);
+		while( (m_count == 0) && !m_is_read_complete ){
+			pthread_cond_wait(&m_cond, &m_mutex);
+		}
+		int result;
+		if( m_count ){
+			page = &m_page_list.at(m_tail);
+			result = m_size_list.at(m_tail);
+		} else {
+			page = nullptr;
+			result = m_read_result;
+		}
+		pthread_mutex_unlock(&m_mutex);
+		return result;
+	}
+
+	void release_page(){
+		pthread_mutex_lock(&m_mutex);
+		m_tail = (m_tail + 1) % m_page_list.size();
+		m_count--;
+		pthread_cond_broadcast(&m_cond);
+		pthread_mutex_unlock(&m_mutex);
+	}
+
+	void abort(){
+		pthread_mutex_lock(&m_mutex);
+		m_is_abort = true;
+		pthread_cond_broadcast(&m_cond);
+		pthread_mutex_unlock(&m_mutex);
+	}
+
+private:
+	const File & m_source_file;
+	u32 m_page_size;
+	u32 m_file_size;
+	std::vector<var::Data> m_page_list;
+	std::vector<int> m_size_list;
+	u32 m_head = 0;
+	u32 m_tail = 0;
+	u32 m_count = 0;
+	int m_read_result = 0;
+	bool m_is_read_complete = false;
+	bool m_is_abort = false;
+	pthread_mutex_t m_mutex;
+	pthread_cond_t m_cond;
+
+	void * read_source_file(){
+		u32 size_read = 0;
+		int result = 0;
+		do {
+			pthread_mutex_lock(&m_mutex);
+			while( (m_count == m_page_list.size()) && !m_is_abort ){
+				pthread_cond_wait(&m_cond, &m_mutex);
+			}
+			bool is_abort = m_is_abort;
+			u32 head = m_head;
+			pthread_mutex_unlock(&m_mutex);
+
+			if( is_abort ){ break; }
+
+			//only the reader touches the head page until it is published
+			u32 page_size = m_page_size;
+			if( m_file_size - size_read < page_size ){
+				page_size = m_file_size - size_read;
+			}
+
+			result = m_source_file.read(
+						m_page_list.at(head).to_void(),
+						File::Size(page_size)
+						);
+
+			if( result > 0 ){
+				size_read += static_cast<u32>(result);
+				pthread_mutex_lock(&m_mutex);
+				m_size_list.at(head) = result;
+				m_head = (m_head + 1) % m_page_list.size();
+				m_count++;
+				pthread_cond_broadcast(&m_cond);
+				pthread_mutex_unlock(&m_mutex);
+			}
+		} while( (result > 0) && (size_read < m_file_size) );
+
+		pthread_mutex_lock(&m_mutex);
+		m_read_result = result < 0 ? result : 0;
+		m_is_read_complete = true;
+		pthread_cond_broadcast(&m_cond);
+		pthread_mutex_unlock(&m_mutex);
+		return nullptr;
+	}
+};
+/*! \endcond */
+
+}
+
+int File::write_pipelined(
+		const File & source_file,
+		const WriteOptions & options
+		) const {
+
+#if defined __link
+	//the link protocol is not thread safe when both files use the same connection
+	if( (driver() != nullptr) && (driver() == source_file.driver()) ){
+		return write(
+					source_file,
+					PageSize(options.page_size()),
+					Size(options.size()),
+					options.progress_callback()
+					);
+	}
+	const u32 reader_stack_size = 65536;
+#else
+	const u32 reader_stack_size = 2048;
+#endif
+
+	const sys::ProgressCallback * progress_callback = options.progress_callback();
+	u32 file_size = static_cast<u32>(options.size());
+	if( options.size() == static_cast<size_t>(-1) ){
+		file_size = source_file.size();
+	}
+
+	u32 page_size = options.page_size();
+	if( page_size == 0 ){
+		page_size = SAPI_LINK_DEFAULT_PAGE_SIZE;
+	}
+
+	if( file_size == 0 ){
+		if( progress_callback ){
+			progress_callback->update(0,100);
+			progress_callback->update(100,100);
+			progress_callback->update(0,0);
+		}
+		return 0;
+	}
+
+	FilePipeline pipeline(
+				source_file,
+				options.pipeline_depth(),
+				page_size,
+				file_size
+				);
+
+	if( pipeline.is_valid() == false ){
+		return set_error_number_if_error(-1);
+	}
+
+	sys::Thread reader_thread(
+				sys::Thread::StackSize(reader_stack_size),
+				sys::Thread::IsDetached(false)
+				);
+
+	if( reader_thread.create(
+				sys::Thread::Function(FilePipeline::read_source_file),
+				sys::Thread::FunctionArgument(&pipeline)
+				) < 0 ){
+		//can't create a thread -- use the serial implementation
+		return write(
+					source_file,
+					PageSize(page_size),
+					Size(file_size),
+					progress_callback
+					);
+	}
+
+	chrono::Timer timer;
+	timer.start();
+
+	u32 size_processed = 0;
+	int result;
+	do {
+		const var::Data * page;
+		result = pipeline.acquire_page(page);
+		if( result > 0 ){
+			result = write(
+						page->to_const_void(),
+						Size(static_cast<size_t>(result))
+						);
+			pipeline.release_page();
+			if( result > 0 ){
+				size_processed += static_cast<u32>(result);
+			} else if( result < 0 ){
+				//same as the serial version -- a failed write is an error
+				pipeline.abort();
+				reader_thread.join();
+				if( progress_callback ){ progress_callback->update(0,0); }
+				return set_error_number_if_error(result);
+			}
+		}
+
+		if( (result > 0) && progress_callback ){
+			u32 microseconds = timer.microseconds();
+			u32 rate = 0;
+			if( microseconds ){
+				rate = static_cast<u32>(
+							(static_cast<u64>(size_processed) * 1000000UL) / microseconds
+							);
+			}
+			//abort the transaction
+			if( progress_callback->update(
+						static_cast<int>(size_processed),
+						static_cast<int>(file_size),
+						rate
+						) == true ){
+				break;
+			}
+		}
+
+	} while( (result > 0) && (file_size > size_processed) );
+
+	pipeline.abort();
+	reader_thread.join();
+
+	//this will terminate the progress operation
+	if( progress_callback ){ progress_callback->update(0,0); }
+	if( (result < 0) && (size_processed == 0) ){
+		return set_error_number_if_error(result);
+	}
+	return set_error_number_if_error(static_cast<int>(size_processed));
+}
+
 DataFile::DataFile(
 		fs::File::Path file_path
 		){
@@ -801,6 +1069,7 @@ DataFile::DataFile(
 	m_fd = 0;
 	m_location = 0;
 	if( info.is_valid() && info.is_file() ){
+		reserve(info.size());
 		File f;
 		if( f.open(
 					file_path.argument(),
@@ -835,6 +1104,7 @@ int DataFile::read(
 		return set_error_number_if_error(api::error_code_fs_cant_read);
 	}
 
+	join_chunk_list();
 	int size_ready = static_cast<int>(m_data.size()) - m_location;
 	if( size_ready > static_cast<int>(nbyte.argument()) ){
 		size_ready = static_cast<int>(nbyte.argument());
@@ -866,14 +1136,21 @@ int DataFile::write(
 
 	u32 size_ready = 0;
 	if( flags().is_append() ){
+		if( growth_policy() == growth_policy_chunk_list ){
+			append_chunk_list(buf, nbyte.argument());
+			m_location = static_cast<int>(size());
+			return set_error_number_if_error(static_cast<int>(nbyte.argument()));
+		}
+
 		//make room in the m_data object for more bytes
 		m_location = static_cast<int>(m_data.size());
-		if( m_data.resize(m_data.size() + nbyte.argument()) < 0 ){
+		if( grow(nbyte.argument()) < 0 ){
 			set_error_number_to_errno();
 			return set_error_number_if_error(-1);
 		}
 		size_ready = nbyte.argument();
 	} else {
+		join_chunk_list();
 		//limit writes to the current size of the data
 		if( static_cast<int>(m_data.size()) > m_location ){
 			size_ready = m_data.size() - static_cast<u32>(m_location);
@@ -900,6 +1177,7 @@ int DataFile::seek(
 		int location,
 		enum whence whence
 		) const {
+	join_chunk_list();
 	switch(whence){
 		case whence_current:
 			m_location += location;
@@ -1011,6 +1289,87 @@ int ReferenceFile::seek(int location,
 	return m_location;
 }
 
+int DataFile::grow(u32 size) const {
+	const u32 required_size = m_data.size() + size;
+	if( required_size > m_data.capacity() ){
+		u32 capacity;
+		const u32 chunk_size = growth_chunk_size() ? growth_chunk_size() : 1;
+		if( growth_policy() == growth_policy_fixed_chunk ){
+			capacity = ((required_size + chunk_size - 1) / chunk_size) * chunk_size;
+		} else {
+			//geometric growth keeps many small writes O(n) overall
+			capacity = m_data.capacity() * 2;
+			if( capacity < chunk_size ){ capacity = chunk_size; }
+			if( capacity < required_size ){ capacity = required_size; }
+		}
+		m_data.reserve(capacity);
+	}
+	return m_data.resize(required_size);
+}
+
+void DataFile::append_chunk_list(const void * buf, u32 size) const {
+	const u8 * source = static_cast<const u8*>(buf);
+	const u32 chunk_size = growth_chunk_size() ? growth_chunk_size() : 1;
+
+	while( size ){
+		//chunks are allocated at full size so copying the list doesn't shrink them
+		//the fill count is tracked per chunk because growth_chunk_size() can change
+		if( m_chunk_list.count() == 0 || m_chunk_fill == m_chunk_list.back().size() ){
+			m_chunk_list.push_back(var::Data(chunk_size));
+			m_chunk_fill = 0;
+		}
+
+		var::Data & chunk = m_chunk_list.back();
+		const u32 offset = m_chunk_fill;
+		u32 page_size = chunk.size() - offset;
+		if( page_size > size ){ page_size = size; }
+
+		var::Reference::memory_copy(
+					SourceBuffer(source),
+					DestinationBuffer(chunk.to_u8() + offset),
+					Size(page_size)
+					);
+
+		source += page_size;
+		size -= page_size;
+		m_chunk_list_size += page_size;
+		m_chunk_fill += page_size;
+	}
+}
+
+void DataFile::join_chunk_list() const {
+	if( m_chunk_list_size == 0 ){
+		return;
+	}
+
+	//one copy in to a buffer that is allocated once
+	u32 offset = m_data.size();
+	u32 remaining = m_chunk_list_size;
+	m_data.resize(offset + m_chunk_list_size);
+	for(const var::Data & chunk: m_chunk_list){
+		u32 page_size = chunk.size() < remaining ? chunk.size() : remaining;
+		var::Reference::memory_copy(
+					SourceBuffer(chunk.to_const_u8()),
+					DestinationBuffer(m_data.to_u8() + offset),
+					Size(page_size)
+					);
+		offset += page_size;
+		remaining -= page_size;
+	}
+
+	m_chunk_list.clear();
+	m_chunk_list_size = 0;
+	m_chunk_fill = 0;
+}
+
+var::Data DataFile::release_data(){
+	join_chunk_list();
+	var::Data result(std::move(m_data));
+	m_data = var::Data();
+	m_location = 0;
+	return result;
+}
+
 int NullFile::open(
 		const var::String & name,
 		const OpenFlags & flags
@@ -1046,3 +1405,177 @@ int NullFile::seek(int location,
 
 }
 
+
+BufferedFile::BufferedFile(
+		const File & file,
+		Size capacity
+		) : m_file(file), m_buffer(capacity.argument()){
+	m_fd = 0;
+}
+
+int BufferedFile::fill() const {
+	discard();
+	int result = m_file.read(m_buffer.to_void(), Size(m_buffer.size()));
+	if( result > 0 ){
+		m_tail = static_cast<u32>(result);
+	} else if( result < 0 ){
+		set_error_number(m_file.error_number());
+	}
+	return result;
+}
+
+int BufferedFile::read(
+		void * buf,
+		Size nbyte
+		) const {
+	u8 * destination = static_cast<u8*>(buf);
+	u32 bytes_read = 0;
+
+	while( bytes_read < nbyte.argument() ){
+		u32 remaining = nbyte.argument() - bytes_read;
+
+		if( available() == 0 ){
+			int result;
+			if( remaining >= capacity() ){
+				//large reads bypass the buffer
+				result = m_file.read(destination + bytes_read, Size(remaining));
+				if( result < 0 ){
+					set_error_number(m_file.error_number());
+				}
+			} else {
+				result = fill();
+			}
+
+			if( result <= 0 ){
+				if( bytes_read == 0 ){ return result; }
+				return bytes_read;
+			}
+
+			if( remaining >= capacity() ){
+				bytes_read += static_cast<u32>(result);
+				continue;
+			}
+		}
+
+		u32 page_size = available() < remaining ? available() : remaining;
+		memcpy(destination + bytes_read, m_buffer.to_u8() + m_head, page_size);
+		m_head += page_size;
+		bytes_read += page_size;
+	}
+
+	return bytes_read;
+}
+
+int BufferedFile::write(
+		const void * buf,
+		Size nbyte
+		) const {
+	if( available() ){
+		//move the underlying file back to the logical location
+		if( m_file.seek(
+					-1*static_cast<int>(available()),
+					whence_current
+					) < 0 ){
+			set_error_number(m_file.error_number());
+			return -1;
+		}
+	}
+	discard();
+	int result = m_file.write(buf, nbyte);
+	if( result < 0 ){
+		set_error_number(m_file.error_number());
+	}
+	return result;
+}
+
+int BufferedFile::seek(
+		int location,
+		enum whence whence
+		) const {
+	int result;
+	if( whence == whence_current ){
+		int buffered = static_cast<int>(available());
+		if( location == 0 ){
+			//report the location without discarding the buffer
+			result = m_file.seek(0, whence_current);
+			if( result >= 0 ){ result -= buffered; }
+		} else {
+			discard();
+			result = m_file.seek(location - buffered, whence_current);
+		}
+	} else {
+		discard();
+		result = m_file.seek(location, whence);
+	}
+
+	if( result < 0 ){
+		set_error_number(m_file.error_number());
+	}
+	return result;
+}
+
+const char * BufferedFile::gets(var::String & s, char term) const {
+	s.clear();
+	while( 1 ){
+		if( available() == 0 && (fill() <= 0) ){
+			return nullptr;
+		}
+
+		const char * start = m_buffer.to_const_char() + m_head;
+		const char * end = static_cast<const char*>(
+					memchr(start, term, available())
+					);
+
+		if( end ){
+			u32 length = static_cast<u32>(end - start) + 1;
+			s.append(var::String(start, var::String::Length(length)));
+			m_head += length;
+			return s.cstring();
+		}
+
+		s.append(var::String(start, var::String::Length(available())));
+		m_head = m_tail;
+	}
+}
+
+int BufferedFile::readline(
+		char * buf,
+		int nbyte,
+		int timeout,
+		char term
+		) const {
+	int t = 0;
+	int bytes_recv = 0;
+
+	while( (bytes_recv < nbyte) && (t < timeout) ){
+		if( available() == 0 && (fill() <= 0) ){
+			t++;
+#if !defined __link
+			chrono::wait(chrono::Milliseconds(1));
+#endif
+			continue;
+		}
+
+		u32 page_size = available();
+		if( page_size > static_cast<u32>(nbyte - bytes_recv) ){
+			page_size = static_cast<u32>(nbyte - bytes_recv);
+		}
+
+		const char * start = m_buffer.to_const_char() + m_head;
+		const char * end = static_cast<const char*>(
+					memchr(start, term, page_size)
+					);
+		if( end ){
+			page_size = static_cast<u32>(end - start) + 1;
+		}
+
+		memcpy(buf + bytes_recv, start, page_size);
+		m_head += page_size;
+		bytes_recv += page_size;
+		if( end ){
+			return bytes_recv;
+		}
+	}
+
+	return bytes_recv;
+}
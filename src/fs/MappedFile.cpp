@@ -0,0 +1,178 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#if defined __win32
+#include <winsock2.h>
+#include <windows.h>
+#undef ERROR
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <cerrno>
+
+#include "fs/MappedFile.hpp"
+
+using namespace fs;
+
+MappedFile::MappedFile(){}
+
+MappedFile::MappedFile(const var::String & path){
+	map(path);
+}
+
+MappedFile::~MappedFile(){
+	unmap();
+}
+
+void MappedFile::move_object(MappedFile & a){
+	m_reference = a.m_reference;
+	m_address = a.m_address;
+	m_file_handle = a.m_file_handle;
+	m_mapping_handle = a.m_mapping_handle;
+	m_is_mapped = a.m_is_mapped;
+
+	a.m_reference = var::Reference();
+	a.m_address = nullptr;
+	a.m_file_handle = nullptr;
+	a.m_mapping_handle = nullptr;
+	a.m_is_mapped = false;
+}
+
+int MappedFile::map(const var::String & path){
+	unmap();
+
+#if defined __win32
+	HANDLE file_handle = CreateFileA(
+				path.cstring(),
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr
+				);
+	if( file_handle == INVALID_HANDLE_VALUE ){
+		set_error_number(ENOENT);
+		return -1;
+	}
+
+	LARGE_INTEGER file_size;
+	if( GetFileSizeEx(file_handle, &file_size) == 0 ){
+		CloseHandle(file_handle);
+		set_error_number(EIO);
+		return -1;
+	}
+
+	m_file_handle = file_handle;
+	m_is_mapped = true;
+	if( file_size.QuadPart == 0 ){
+		//an empty file can't be mapped but is still valid
+		return 0;
+	}
+
+	HANDLE mapping_handle = CreateFileMappingA(
+				file_handle,
+				nullptr,
+				PAGE_READONLY,
+				0,
+				0,
+				nullptr
+				);
+	if( mapping_handle == nullptr ){
+		unmap();
+		set_error_number(ENOMEM);
+		return -1;
+	}
+	m_mapping_handle = mapping_handle;
+
+	m_address = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if( m_address == nullptr ){
+		unmap();
+		set_error_number(ENOMEM);
+		return -1;
+	}
+
+	m_reference.refer_to(
+				var::Reference::ReadOnlyBuffer(m_address),
+				var::Reference::Size(static_cast<size_t>(file_size.QuadPart))
+				);
+#else
+	int fd = ::open(path.cstring(), O_RDONLY);
+	if( fd < 0 ){
+		set_error_number_to_errno();
+		return -1;
+	}
+
+	struct stat st;
+	if( ::fstat(fd, &st) < 0 ){
+		set_error_number_to_errno();
+		::close(fd);
+		return -1;
+	}
+
+	m_is_mapped = true;
+	if( st.st_size == 0 ){
+		//an empty file can't be mapped but is still valid
+		::close(fd);
+		return 0;
+	}
+
+	void * address = ::mmap(
+				nullptr,
+				static_cast<size_t>(st.st_size),
+				PROT_READ,
+				MAP_PRIVATE,
+				fd,
+				0
+				);
+
+	//the mapping stays valid after the descriptor is closed
+	::close(fd);
+
+	if( address == MAP_FAILED ){
+		m_is_mapped = false;
+		set_error_number_to_errno();
+		return -1;
+	}
+
+	m_address = address;
+	m_reference.refer_to(
+				var::Reference::ReadOnlyBuffer(m_address),
+				var::Reference::Size(static_cast<size_t>(st.st_size))
+				);
+#endif
+
+	return 0;
+}
+
+int MappedFile::unmap(){
+	int result = 0;
+
+#if defined __win32
+	if( m_address ){
+		if( UnmapViewOfFile(m_address) == 0 ){ result = -1; }
+	}
+	if( m_mapping_handle ){
+		CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+	}
+	if( m_file_handle ){
+		CloseHandle(static_cast<HANDLE>(m_file_handle));
+	}
+#else
+	if( m_address ){
+		result = ::munmap(m_address, m_reference.size());
+		if( result < 0 ){
+			set_error_number_to_errno();
+		}
+	}
+#endif
+
+	m_reference = var::Reference();
+	m_address = nullptr;
+	m_file_handle = nullptr;
+	m_mapping_handle = nullptr;
+	m_is_mapped = false;
+	return result;
+}
@@ -323,15 +323,15 @@ int HttpClient::build_header(const var::String & method, const var::String & hos
 	bool is_accept_present = false;
 	bool is_keep_alive_present = false;
 	m_header.clear();
+	//most headers fit without growing the string again
+	m_header.reserve(256);
 	m_header << method << " " << path << " HTTP/1.1\r\n";
 	m_header << "Host: " << host << "\r\n";
 
 	for(u32 i = 0; i < header_request_pairs().count(); i++){
 		String key = header_request_pairs().at(i).key();
 		if( key.is_empty() == false ){
-			String entry;
-			entry << key << ": " << header_request_pairs().at(i).value() << "\r\n";
-			m_header << entry;
+			m_header << key << ": " << header_request_pairs().at(i).value() << "\r\n";
 			key.to_lower();
 			if( key == "user-Agent" ){ is_user_agent_present = true; }
 			if( key == "accept" ){ is_accept_present = true; }
@@ -348,7 +348,8 @@ int HttpClient::build_header(const var::String & method, const var::String & hos
 	if( !is_accept_present ){ m_header << "Accept: */*\r\n"; }
 
 	if( length > 0 ){
-		m_header << "Content-Length: " << String::number(length) << "\r\n";
+		m_header << "Content-Length: ";
+		m_header.append_unsigned(length) << "\r\n";
 	}
 	m_header << "\r\n";
 
@@ -503,32 +504,26 @@ int HttpClient::listen_for_data(
 HttpHeaderPair HttpHeaderPair::from_string(
 		const var::String & string
 		){
-	String string_copy = string;
-	size_t colon_pos = string_copy.find(":");
+	const StringView line(string);
+	const CharacterSet line_end("\r\n");
+	size_t colon_pos = line.find(':');
 
-	String key = string_copy.create_sub_string(
-				String::Position(0),
-				String::Length(colon_pos)
-				);
+	String key = line.sub_view(0, colon_pos).to_string();
 	String value;
-	if( colon_pos != String::npos ){
-		value = string_copy.create_sub_string(
-					String::Position(colon_pos+1)
-					);
-		if( value.at(0) == ' ' ){
-			value.erase(
-						String::Position(0),
-						String::Length(1)
-						);
+	if( colon_pos != StringView::npos ){
+		size_t value_pos = colon_pos+1;
+		if( (value_pos < line.length()) && (line.at(value_pos) == ' ') ){
+			value_pos++;
 		}
-		value.replace(
-					String::ToErase("\r"),
-					String::ToInsert("")
-					);
-		value.replace(
-					String::ToErase("\n"),
-					String::ToInsert("")
-					);
+
+		//copy the value once leaving out any CR/LF characters
+		size_t position = value_pos;
+		size_t end;
+		while( (end = line_end.find(line, position)) != CharacterSet::npos ){
+			value.string().append(line.data() + position, end - position);
+			position = end+1;
+		}
+		value.string().append(line.data() + position, line.length() - position);
 	}
 	return HttpHeaderPair(key, value);
 }
@@ -2,6 +2,7 @@
 /* Copyright 2016-2018 Tyler Gilbert ALl Rights Reserved */
 
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
@@ -16,6 +17,7 @@
 #include "sys/Link.hpp"
 #include "sys/Appfs.hpp"
 #include "chrono/Timer.hpp"
+#include "crypto/Sha256.hpp"
 
 using namespace sys;
 using namespace fs;
@@ -26,6 +28,53 @@ static var::String gen_error(const var::String & msg, int err_number){
 	return s;
 }
 
+namespace {
+
+using PageDigest = var::Array<u8, 32>;
+
+//calculates the digest of each page of file starting at the beginning of the file
+int calculate_page_digest_list(
+		const File & file,
+		u32 page_size,
+		var::Vector<PageDigest> & digest_list
+		){
+	var::Data page(page_size);
+	int result;
+
+	if( file.seek(File::Location(0), File::whence_set) < 0 ){
+		return -1;
+	}
+
+	digest_list.clear();
+	while( (result = file.read(page)) > 0 ){
+		crypto::Sha256 page_hash;
+		if( page_hash.initialize() < 0 || page_hash.start() < 0 ){
+			return -1;
+		}
+		page_hash.update(
+					var::Reference::SourceBuffer(page.to_const_void()),
+					var::Reference::Size(result)
+					);
+		digest_list.push_back(page_hash.output());
+	}
+	return result;
+}
+
+//returns the entry in a sorted list that matches path or nullptr
+const LinkSyncEntry * find_sync_entry(
+		const var::Vector<LinkSyncEntry> & list,
+		const var::String & path
+		){
+	const LinkSyncEntry key(path);
+	auto iterator = std::lower_bound(list.begin(), list.end(), key);
+	if( (iterator != list.end()) && (iterator->path() == path) ){
+		return &(*iterator);
+	}
+	return nullptr;
+}
+
+}
+
 Link::Link(){
 	link_load_default_driver( driver() );
 }
@@ -900,11 +949,11 @@ int Link::copy(
 			m_error_message = "";
 			int result = device_file.write(
 						host_file,
-						fs::File::PageSize(
-							static_cast<u32>(copy_page_size)
-							),
-						fs::File::Size(host_file.size()),
-						progress_callback
+						fs::File::WriteOptions()
+						.set_page_size(static_cast<u32>(copy_page_size))
+						.set_size(host_file.size())
+						.set_progress_callback(progress_callback)
+						.set_pipelined()
 						);
 			if( result < 0 ){
 
@@ -963,9 +1012,11 @@ int Link::copy(
 
 		if( host_file.write(
 					device_file,
-					fs::File::PageSize(copy_page_size),
-					fs::File::Size(device_file.size()),
-					progress_callback
+					fs::File::WriteOptions()
+					.set_page_size(static_cast<u32>(copy_page_size))
+					.set_size(device_file.size())
+					.set_progress_callback(progress_callback)
+					.set_pipelined()
 					) < 0 ){
 			m_error_message.format(
 						"failed to write to host file"
@@ -993,6 +1044,384 @@ int Link::copy(
 	return 0;
 }
 
+int Link::sync(
+		SourcePath host_directory,
+		DestinationPath device_directory,
+		const SyncOptions & options
+		){
+	const var::String & host_path = host_directory.argument();
+	const var::String & device_path = device_directory.argument();
+	const ProgressCallback * progress_callback = options.progress_callback();
+	struct link_stat st;
+
+	if ( m_is_bootloader ){
+		return -1;
+	}
+
+	//hashing on the host is cheap compared to reading the device
+	var::Vector<LinkSyncEntry> host_list;
+	var::Vector<var::String> host_file_list =
+			Dir::read_list(
+				host_path,
+				Dir::IsRecursive(true)
+				);
+
+	for(const var::String & entry: host_file_list){
+		var::String path = host_path + "/" + entry;
+		LinkSyncEntry host_entry(entry);
+		host_entry
+				.set_size(File::size(path))
+				.set_digest(crypto::Sha256::calculate(path));
+		if( host_entry.digest().is_empty() ){
+			m_error_message.format("Failed to read %s on host", path.cstring());
+			return -1;
+		}
+		host_list.push_back(host_entry);
+	}
+	host_list.sort(var::Vector<LinkSyncEntry>::ascending);
+
+	var::Vector<LinkSyncEntry> device_list;
+	var::Vector<LinkSyncEntry> manifest_list;
+	var::Vector<var::String> directory_list;
+
+	if( link_stat(driver(), device_path.cstring(), &st) < 0 ){
+		if( Dir::create(
+					device_path,
+					Permissions(0777),
+					Dir::IsRecursive(true),
+					Dir::LinkDriver(driver())
+					) < 0 ){
+			m_error_message.format(
+						"Failed to create %s on device (%d)",
+						device_path.cstring(),
+						link_errno
+						);
+			return -1;
+		}
+	} else {
+		if( read_sync_device_list(
+					device_path,
+					var::String(),
+					device_list,
+					directory_list
+					) < 0 ){
+			return -1;
+		}
+
+		//a missing or unreadable manifest just means every file is checked
+		read_sync_manifest(device_path, manifest_list);
+	}
+
+	device_list.sort(var::Vector<LinkSyncEntry>::ascending);
+	manifest_list.sort(var::Vector<LinkSyncEntry>::ascending);
+
+	var::Vector<LinkSyncEntry> updated_manifest_list;
+	int copy_count = 0;
+	int failed_count = 0;
+	u32 progress = 0;
+
+	for(const LinkSyncEntry & host_entry: host_list){
+		var::String path = device_path + "/" + host_entry.path();
+		const LinkSyncEntry * device_entry =
+				find_sync_entry(device_list, host_entry.path());
+		LinkSyncEntry updated_entry(host_entry);
+		bool is_current = false;
+		bool is_recorded = true;
+
+		if( device_entry && (device_entry->size() == host_entry.size()) ){
+			const LinkSyncEntry * manifest_entry =
+					find_sync_entry(manifest_list, host_entry.path());
+
+			if( manifest_entry &&
+					(manifest_entry->size() == device_entry->size()) &&
+					(manifest_entry->mtime() == device_entry->mtime()) ){
+				is_current = manifest_entry->digest() == host_entry.digest();
+			} else if( options.is_verify_device() ){
+				File device_file(File::LinkDriver(driver()));
+				if( device_file.open(
+							path,
+							OpenFlags::read_only()
+							) == 0 ){
+					is_current =
+							crypto::Sha256::calculate(
+								device_file,
+								crypto::Sha256::PageSize(flash_digest_page_size())
+								) == host_entry.digest();
+					device_file.close();
+				}
+			}
+		}
+
+		if( is_current ){
+			updated_entry.set_mtime(device_entry->mtime());
+		} else {
+			var::String parent = File::parent_directory(host_entry.path());
+			if( !parent.is_empty() &&
+					(directory_list.find(parent) == directory_list.count()) ){
+				//ancestors that already exist just fail to be created
+				Dir::create(
+							device_path + "/" + parent,
+							Permissions(0777),
+							Dir::IsRecursive(true),
+							Dir::LinkDriver(driver())
+							);
+				directory_list.push_back(parent);
+			}
+
+			if( copy(
+						SourcePath(host_path + "/" + host_entry.path()),
+						DestinationPath(path),
+						Permissions(options.permissions()),
+						IsCopyToDevice(true)
+						) < 0 ){
+				return -1;
+			}
+
+			if( link_stat(driver(), path.cstring(), &st) < 0 ){
+				m_error_message.format(
+							"Failed to stat %s on device (%d)",
+							path.cstring(),
+							link_errno
+							);
+				return -1;
+			}
+
+			//a truncated copy must not be recorded or it will never be sent again
+			if( static_cast<u32>(st.st_size) != host_entry.size() ){
+				m_error_message.format(
+							"Failed to copy %s to device (" F32U " of " F32U " bytes)",
+							path.cstring(),
+							static_cast<u32>(st.st_size),
+							host_entry.size()
+							);
+				failed_count++;
+				is_recorded = false;
+			} else {
+				updated_entry.set_mtime(st.st_mtime);
+				copy_count++;
+			}
+		}
+
+		if( is_recorded ){
+			updated_manifest_list.push_back(updated_entry);
+		}
+		progress++;
+		if( progress_callback ){
+			progress_callback->update(progress, host_list.count());
+		}
+	}
+
+	if( options.is_remove_stale() ){
+		for(const LinkSyncEntry & device_entry: device_list){
+			if( find_sync_entry(host_list, device_entry.path()) == nullptr ){
+				if( unlink(device_path + "/" + device_entry.path()) < 0 ){
+					return -1;
+				}
+			}
+		}
+	}
+
+	if( progress_callback ){
+		progress_callback->update(0,0);
+	}
+
+	if( write_sync_manifest(device_path, updated_manifest_list) < 0 ){
+		return -1;
+	}
+
+	if( failed_count ){
+		//the files that were copied are still recorded in the manifest
+		return -1;
+	}
+
+	return copy_count;
+}
+
+int Link::read_sync_device_list(
+		const var::String & device_directory,
+		const var::String & relative_path,
+		var::Vector<LinkSyncEntry> & list,
+		var::Vector<var::String> & directory_list
+		){
+	var::String directory_path = device_directory;
+	if( !relative_path.is_empty() ){
+		directory_path << "/" << relative_path;
+	}
+
+	int dirp = opendir(directory_path);
+	if( dirp <= 0 ){
+		return -1;
+	}
+
+	//read all the names before recursing so only one directory is open at a time
+	var::Vector<var::String> name_list;
+	struct link_dirent entry;
+	struct link_dirent * result;
+	while( 1 ){
+		memset(&entry, 0, sizeof(entry));
+		if( (readdir_r(dirp, &entry, &result) < 0) ||
+				(result == nullptr) ||
+				(entry.d_name[0] == 0) ){
+			break;
+		}
+		var::String name(entry.d_name);
+		if( (name != ".") && (name != "..") ){
+			name_list.push_back(name);
+		}
+	}
+
+	if( closedir(dirp) < 0 ){
+		return -1;
+	}
+
+	for(const var::String & name: name_list){
+		var::String entry_path =
+				relative_path.is_empty() ? name : relative_path + "/" + name;
+
+		if( entry_path == sync_manifest_name() ){
+			continue;
+		}
+
+		struct link_stat st;
+		if( stat(device_directory + "/" + entry_path, st) < 0 ){
+			return -1;
+		}
+
+		if( (st.st_mode & LINK_S_IFMT) == LINK_S_IFDIR ){
+			directory_list.push_back(entry_path);
+			if( read_sync_device_list(
+						device_directory,
+						entry_path,
+						list,
+						directory_list
+						) < 0 ){
+				return -1;
+			}
+		} else if( (st.st_mode & LINK_S_IFMT) == LINK_S_IFREG ){
+			LinkSyncEntry device_entry(entry_path);
+			device_entry
+					.set_size(st.st_size)
+					.set_mtime(st.st_mtime);
+			list.push_back(device_entry);
+		}
+	}
+
+	return 0;
+}
+
+int Link::read_sync_manifest(
+		const var::String & device_directory,
+		var::Vector<LinkSyncEntry> & list
+		){
+	var::String path = device_directory + "/" + sync_manifest_name();
+	File manifest_file(File::LinkDriver(driver()));
+	struct link_stat st;
+
+	list.clear();
+	if( link_stat(driver(), path.cstring(), &st) < 0 ){
+		return -1;
+	}
+
+	if( manifest_file.open(
+				path,
+				OpenFlags::read_only()
+				) < 0 ){
+		return -1;
+	}
+
+	//the whole manifest is read at once rather than a line at a time
+	var::Data content(st.st_size + 1);
+	int result = manifest_file.read(
+				content.to_void(),
+				File::Size(st.st_size)
+				);
+	manifest_file.close();
+	if( result < 0 ){
+		return -1;
+	}
+	content.to_char()[result] = 0;
+
+	//each line is: <digest> <size> <mtime> <path>
+	char * line = content.to_char();
+	while( *line ){
+		char * end = strchr(line, '\n');
+		if( end ){
+			*end = 0;
+		}
+
+		char digest[65];
+		unsigned int size;
+		unsigned int mtime;
+		int offset = 0;
+		if( (sscanf(line, "%64s %u %u %n", digest, &size, &mtime, &offset) == 3) &&
+				(offset > 0) &&
+				(line[offset] != 0) ){
+			LinkSyncEntry manifest_entry(line + offset);
+			manifest_entry
+					.set_digest(digest)
+					.set_size(size)
+					.set_mtime(mtime);
+			list.push_back(manifest_entry);
+		}
+
+		if( end == nullptr ){
+			break;
+		}
+		line = end + 1;
+	}
+
+	return 0;
+}
+
+int Link::write_sync_manifest(
+		const var::String & device_directory,
+		const var::Vector<LinkSyncEntry> & list
+		){
+	var::String path = device_directory + "/" + sync_manifest_name();
+	File manifest_file(File::LinkDriver(driver()));
+	var::String content;
+
+	for(const LinkSyncEntry & entry: list){
+		var::String line;
+		line.format(
+					"%s " F32U " " F32U " %s\n",
+					entry.digest().cstring(),
+					entry.size(),
+					entry.mtime(),
+					entry.path().cstring()
+					);
+		content << line;
+	}
+
+	if( manifest_file.create(
+				path,
+				File::IsOverwrite(true),
+				Permissions(0666)
+				) < 0 ){
+		m_error_message.format(
+					"Failed to create %s on device (%d)",
+					path.cstring(),
+					link_errno
+					);
+		return -1;
+	}
+
+	if( manifest_file.write(
+				content.cstring(),
+				File::Size(content.length())
+				) != static_cast<int>(content.length()) ){
+		m_error_message.format(
+					"Failed to write %s on device (%d)",
+					path.cstring(),
+					link_errno
+					);
+		manifest_file.close();
+		return -1;
+	}
+
+	return manifest_file.close();
+}
+
 int Link::run_app(const var::String & path){
 	int err = -1;
 	if ( m_is_bootloader ){
@@ -1345,6 +1774,15 @@ int Link::install_os(
 		return -1;
 	}
 
+	const bool is_digest_verify = is_verify.argument() && m_is_digest_verify;
+	crypto::Sha256 image_hash;
+	if( is_digest_verify ){
+		if( image_hash.initialize() < 0 || image_hash.start() < 0 ){
+			m_error_message = "failed to initialize image digest";
+			return -1;
+		}
+	}
+
 	while(
 				(bytes_read = image.read(buffer) ) > 0
 				){
@@ -1367,6 +1805,14 @@ int Link::install_os(
 
 		}
 
+		if( is_digest_verify ){
+			//the digest matches what is in flash before the start block is written
+			image_hash.update(
+						var::Reference::SourceBuffer(buffer.to_const_void()),
+						var::Reference::Size(bytes_read)
+						);
+		}
+
 		if ( (err = link_writeflash(
 						driver(),
 						loc,
@@ -1395,7 +1841,25 @@ int Link::install_os(
 
 	if ( err == 0 ){
 
-		if ( is_verify.argument() == true ){
+		if( is_digest_verify ){
+			progress_printer.progress_key() = "verifying";
+			var::Array<u8, 32> flash_digest;
+			if( (err = calculate_flash_digest(
+						 start_address,
+						 loc - start_address,
+						 flash_digest
+						 )) < 0 ){
+				if( progress_callback ){ progress_callback->update(0,0); }
+				return -1;
+			}
+
+			if( flash_digest.array() != image_hash.output().array() ){
+				m_error_message = "Failed to verify program installation digest";
+				if( progress_callback ){ progress_callback->update(0,0); }
+				return -1;
+			}
+
+		} else if ( is_verify.argument() == true ){
 
 			image.seek(File::Location(0), File::whence_set);
 			loc = start_address;
@@ -1512,6 +1976,261 @@ int Link::install_os(
 	return check_error(err);
 }
 
+int Link::calculate_flash_digest(
+		u32 address,
+		u32 size,
+		var::Array<u8, 32> & digest
+		){
+
+	if ( m_is_bootloader == false ){
+		m_error_message = "Target is not a bootloader";
+		return -1;
+	}
+
+	crypto::Sha256 flash_hash;
+	if( flash_hash.initialize() < 0 || flash_hash.start() < 0 ){
+		m_error_message = "Failed to initialize flash digest";
+		return -1;
+	}
+
+	var::Data page(flash_digest_page_size());
+	u32 offset = 0;
+	while( offset < size ){
+		u32 page_size = size - offset;
+		if( page_size > page.size() ){
+			page_size = page.size();
+		}
+
+		int err = -1;
+		for(int tries = 0; tries < MAX_TRIES; tries++){
+			err = link_readflash(
+						driver(),
+						static_cast<int>(address + offset),
+						page.to_void(),
+						static_cast<int>(page_size)
+						);
+			if(err != LINK_PROT_ERROR) break;
+		}
+
+		if( err != static_cast<int>(page_size) ){
+			m_error_message.format(
+						"Failed to read flash at 0x%x for digest (%d, %d)",
+						address + offset,
+						err,
+						link_errno
+						);
+			return check_error(err < 0 ? err : -1);
+		}
+
+		flash_hash.update(
+					var::Reference::SourceBuffer(page.to_const_void()),
+					var::Reference::Size(page_size)
+					);
+
+		offset += page_size;
+	}
+
+	digest = flash_hash.output();
+	return 0;
+}
+
+int Link::is_os_installed(
+		const fs::File & image,
+		HardwareId image_id
+		){
+	var::Data page(delta_page_size());
+	var::Data flash_page(delta_page_size());
+	u32 address = m_bootloader_attributes.startaddr;
+	u32 size = 0;
+	int result;
+
+	if( image.seek(File::Location(0), File::whence_set) < 0 ){
+		m_error_message = "Failed to seek bootloader image start";
+		return -1;
+	}
+
+	//compare one page at a time so the first difference ends the readback
+	while( (result = image.read(page)) > 0 ){
+		if( (size == 0) &&
+				(image_id.argument() != m_bootloader_attributes.hardware_id) &&
+				(result >= static_cast<int>(BOOTLOADER_HARDWARE_ID_OFFSET + sizeof(u32))) ){
+			//install_os() corrects the hardware ID in the start block
+			var::Reference::memory_copy(
+						var::Reference::SourceBuffer(&m_bootloader_attributes.hardware_id),
+						var::Reference::DestinationBuffer(page.to_u8() + BOOTLOADER_HARDWARE_ID_OFFSET),
+						File::Size( sizeof(u32) )
+						);
+		}
+
+		int err = -1;
+		for(int tries = 0; tries < MAX_TRIES; tries++){
+			err = link_readflash(
+						driver(),
+						static_cast<int>(address),
+						flash_page.to_void(),
+						result
+						);
+			if(err != LINK_PROT_ERROR) break;
+		}
+
+		if( err != result ){
+			m_error_message.format(
+						"Failed to read flash at 0x%x for compare (%d, %d)",
+						address,
+						err,
+						link_errno
+						);
+			return check_error(err < 0 ? err : -1);
+		}
+
+		if( memcmp(page.to_const_void(), flash_page.to_const_void(), result) != 0 ){
+			return 0;
+		}
+
+		address += static_cast<u32>(result);
+		size += static_cast<u32>(result);
+	}
+
+	if( size == 0 ){
+		m_error_message = "Failed to read bootloader image";
+		return -1;
+	}
+
+	return 1;
+}
+
+int Link::install_app_delta(
+		const fs::File & application_image,
+		const var::String & path,
+		const ProgressCallback * progress_callback
+		){
+	File device_file = File(fs::File::LinkDriver(driver()));
+
+	if( device_file.open(
+				path,
+				fs::OpenFlags::read_write()
+				) < 0 ){
+		//nothing to compare against
+		application_image.seek(File::Location(0), File::whence_set);
+		return 1;
+	}
+
+	const u32 image_size = application_image.size();
+	if( device_file.size() != image_size ){
+		device_file.close();
+		application_image.seek(File::Location(0), File::whence_set);
+		return 1;
+	}
+
+	var::Vector<PageDigest> image_digest_list;
+	var::Vector<PageDigest> device_digest_list;
+
+	if( calculate_page_digest_list(
+				application_image,
+				delta_page_size(),
+				image_digest_list
+				) < 0 ||
+			calculate_page_digest_list(
+				device_file,
+				delta_page_size(),
+				device_digest_list
+				) < 0 ){
+		m_error_message.format(
+					"failed to calculate page digests for %s",
+					path.cstring()
+					);
+		device_file.close();
+		return -1;
+	}
+
+	if( image_digest_list.count() != device_digest_list.count() ){
+		device_file.close();
+		//the digests leave the image at EOF, rewind for the full install
+		application_image.seek(File::Location(0), File::whence_set);
+		return 1;
+	}
+
+	var::Vector<u32> page_list;
+	for(u32 i=0; i < image_digest_list.count(); i++){
+		if( image_digest_list.at(i).array() != device_digest_list.at(i).array() ){
+			page_list.push_back(i);
+		}
+	}
+
+	//the first page (with the header) is invalidated before any other page is
+	//patched and written last so a partial update is never mistaken for a valid image
+	if( page_list.count() ){
+		if( page_list.at(0) == 0 ){
+			page_list.remove(0);
+		}
+		page_list.push_back(0);
+	}
+
+	var::Data page(delta_page_size());
+	if( page_list.count() ){
+		const int header_size = static_cast<int>(
+					image_size < delta_page_size() ? image_size : delta_page_size()
+					);
+		page.fill<u8>(0xff);
+		if( device_file.write(
+					File::Location(0),
+					page.to_const_void(),
+					File::Size(header_size)
+					) != header_size ){
+			m_error_message.format(
+						"failed to invalidate the header of %s",
+						path.cstring()
+						);
+			device_file.close();
+			return -1;
+		}
+	}
+
+	const int total = static_cast<int>(page_list.count());
+	for(u32 i=0; i < page_list.count(); i++){
+		const File::Location location(
+					static_cast<int>(page_list.at(i) * delta_page_size())
+					);
+
+		int result = application_image.read(location, page);
+		if( (result <= 0) ||
+				(device_file.write(location, page.to_const_void(), File::Size(result)) != result) ){
+			m_error_message.format(
+						"failed to write page " F32U " of %s",
+						page_list.at(i),
+						path.cstring()
+						);
+			device_file.close();
+			if( progress_callback ){ progress_callback->update(0,0); }
+			return -1;
+		}
+
+		if( progress_callback &&
+				progress_callback->update(static_cast<int>(i+1), total) &&
+				(i+1 < page_list.count()) ){
+			//the header is still invalid so the partial image won't run
+			m_error_message.format(
+						"aborted update of %s",
+						path.cstring()
+						);
+			device_file.close();
+			progress_callback->update(0,0);
+			return -1;
+		}
+	}
+
+	if( progress_callback ){ progress_callback->update(0,0); }
+
+	if( device_file.close() < 0 ){
+		m_error_message.format(
+					"failed to close %s on target",
+					path.cstring()
+					);
+		return -1;
+	}
+	return 0;
+}
+
 int Link::update_os(
 		const fs::File & image,
 		IsVerify is_verify,
@@ -1533,6 +2252,27 @@ int Link::update_os(
 
 	var::String progress_key = progress_printer.progress_key();
 
+	if( m_is_delta_update ){
+		int is_installed = is_os_installed(image, HardwareId(image_id));
+		if( is_installed < 0 ){
+			progress_printer.error(
+						"failed to compare os '%s'",
+						error_message().cstring()
+						);
+			return -1;
+		}
+
+		if( is_installed > 0 ){
+			progress_printer.info("os is already installed");
+			return 0;
+		}
+
+		if( image.seek(File::Location(0), File::whence_set) < 0 ){
+			m_error_message = "Failed to seek bootloader image start";
+			return -1;
+		}
+	}
+
 	if( erase_os(
 				progress_printer,
 				bootloader_retry_total
@@ -1886,6 +2626,18 @@ int Link::install_app(
 		//copy the file to the destination directory
 		var::String dest_str = path.argument() + "/" + name.argument();
 
+		if( m_is_delta_update ){
+			int result = install_app_delta(
+						application_image,
+						dest_str,
+						progress_callback
+						);
+			if( result <= 0 ){
+				return result;
+			}
+			//the existing file can't be patched -- write the whole image
+		}
+
 		if( f.create(
 					dest_str,
 					File::IsOverwrite(true),
@@ -0,0 +1,206 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include "sys/LinkFleet.hpp"
+#include "sys/Thread.hpp"
+#include "chrono/Timer.hpp"
+
+using namespace sys;
+
+namespace {
+
+bool update_device_progress(void * context, int value, int total){
+	static_cast<LinkFleetDevice*>(context)->set_progress(value, total);
+	return false;
+}
+
+}
+
+LinkFleet::LinkFleet(const Options & options) : m_options(options){}
+
+int LinkFleet::discover(){
+	Link link;
+	if( m_options.driver() ){
+		link.set_driver(m_options.driver());
+	}
+
+	var::Vector<LinkInfo> info_list = link.get_info_list();
+	set_info_list(info_list);
+	return static_cast<int>(m_device_list.count());
+}
+
+LinkFleet & LinkFleet::set_info_list(const var::Vector<LinkInfo> & info_list){
+	m_device_list.clear();
+	for(const LinkInfo & info: info_list){
+		m_device_list.push_back(LinkFleetDevice(info));
+	}
+	return *this;
+}
+
+u32 LinkFleet::size() const {
+	u32 result = 0;
+	for(const LinkFleetDevice & device: m_device_list){
+		if( device.is_success() ){
+			result += device.size();
+		}
+	}
+	return result;
+}
+
+int LinkFleet::execute(const Job & job){
+	u32 thread_count = m_options.thread_count();
+	if( thread_count == 0 ){ thread_count = 1; }
+	if( thread_count > m_device_list.count() ){
+		thread_count = m_device_list.count();
+	}
+
+	for(LinkFleetDevice & device: m_device_list){
+		device.set_result(0).set_size(0).set_microseconds(0);
+		device.error_message().clear();
+		device.set_progress(0, 0);
+	}
+
+	m_job = &job;
+	m_next_device = 0;
+
+	chrono::Timer timer;
+	timer.start();
+
+	var::Vector<Thread*> thread_list;
+	for(u32 i=0; i < thread_count; i++){
+		Thread * thread = new Thread(
+					Thread::StackSize(m_options.stack_size()),
+					Thread::IsDetached(false)
+					);
+		if( thread->create(
+					Thread::Function(execute_worker),
+					Thread::FunctionArgument(this)
+					) < 0 ){
+			delete thread;
+			break;
+		}
+		thread_list.push_back(thread);
+	}
+
+	if( thread_list.count() == 0 ){
+		//no worker threads -- execute the job on this thread
+		execute_worker();
+	}
+
+	for(Thread * thread: thread_list){
+		thread->join();
+		delete thread;
+	}
+
+	m_microseconds = timer.microseconds();
+	m_job = nullptr;
+
+	int failure_count = 0;
+	for(const LinkFleetDevice & device: m_device_list){
+		if( device.is_success() == false ){
+			failure_count++;
+		}
+	}
+	return failure_count;
+}
+
+void * LinkFleet::execute_worker(void * args){
+	return static_cast<LinkFleet*>(args)->execute_worker();
+}
+
+void * LinkFleet::execute_worker(){
+	while( 1 ){
+		u32 device_index;
+		{
+			LockGuard lock_guard(m_mutex);
+			device_index = m_next_device++;
+		}
+
+		if( device_index >= m_device_list.count() ){
+			return nullptr;
+		}
+
+		//each device has its own link so a failure stays with the device
+		LinkFleetDevice & device = m_device_list.at(device_index);
+		Link link;
+		if( m_options.driver() ){
+			link.set_driver(m_options.driver());
+		}
+
+		chrono::Timer timer;
+		timer.start();
+
+		if( link.connect(device.info().port()) < 0 ){
+			device.set_result(-1).set_error_message(link.error_message());
+			continue;
+		}
+
+		if( link.serial_number() != device.info().serial_number() ){
+			device.set_result(-1).set_error_message("serial number mismatch");
+			link.disconnect();
+			continue;
+		}
+
+		int result = execute_device(link, device);
+		device.set_result(result).set_microseconds(timer.microseconds());
+		if( (result < 0) && device.error_message().is_empty() ){
+			device.set_error_message(link.error_message());
+		}
+
+		if( link.is_connected() ){
+			link.disconnect();
+		}
+	}
+}
+
+int LinkFleet::execute_device(Link & link, LinkFleetDevice & device){
+	ProgressCallback progress_callback;
+	progress_callback
+			.set_callback(update_device_progress)
+			.set_context(&device);
+
+	fs::File source_file;
+	if( source_file.open(
+				m_job->source_path(),
+				fs::OpenFlags::read_only()
+				) < 0 ){
+		device.set_error_message("failed to open " + m_job->source_path());
+		return -1;
+	}
+
+	device.set_size(source_file.size());
+
+	int result = -1;
+	switch(m_job->type()){
+		case job_type_copy:
+			source_file.close();
+			result = link.copy(
+						Link::SourcePath(m_job->source_path()),
+						Link::DestinationPath(m_job->destination_path()),
+						fs::Permissions(m_job->permissions()),
+						Link::IsCopyToDevice(true),
+						&progress_callback
+						);
+			break;
+		case job_type_install_app:
+			result = link.install_app(
+						source_file,
+						Link::Path(m_job->destination_path()),
+						Link::ApplicationName(m_job->application_name()),
+						&progress_callback
+						);
+			break;
+		case job_type_update_os:
+			if( link.is_bootloader() == false ){
+				device.set_error_message("device is not a bootloader");
+				return -1;
+			}
+			result = link.update_os(
+						source_file,
+						Link::IsVerify(m_job->is_verify()),
+						&progress_callback
+						);
+			break;
+	}
+
+	return result;
+}
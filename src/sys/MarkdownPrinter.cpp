@@ -469,6 +469,8 @@ Printer & MarkdownPrinter::warning(const char * fmt, ...){
 	va_start(list, fmt);
 	print(level_warning, "warning", var::String().vformat(fmt, list).cstring());
 	va_end(list);
+	//the application may exit right after this
+	flush();
 	return *this;
 }
 
@@ -477,6 +479,8 @@ Printer & MarkdownPrinter::error(const char * fmt, ...){
 	va_start(list, fmt);
 	print(level_error, "error", var::String().vformat(fmt, list).cstring());
 	va_end(list);
+	//the application may exit right after this
+	flush();
 	return *this;
 }
 
@@ -485,6 +489,8 @@ Printer & MarkdownPrinter::fatal(const char * fmt, ...){
 	va_start(list, fmt);
 	print(level_fatal, "fatal", var::String().vformat(fmt, list).cstring());
 	va_end(list);
+	//the application may exit right after this
+	flush();
 	return *this;
 }
 
@@ -1,11 +1,17 @@
 /*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
 
 #include <cstdarg>
+#include <cstdio>
+#include <cstring>
 #if defined __win32
 #include <windows.h>
 #endif
+#if defined __link && !defined __win32
+#include <unistd.h>
+#endif
 
 #include "sys/Printer.hpp"
+#include "sys/PrinterSink.hpp"
 #include "sys/Sys.hpp"
 #include "hal/Core.hpp"
 #include "hal/Drive.hpp"
@@ -52,6 +58,80 @@ Printer::Printer() {
 #if defined __link
 	m_is_bash = false;
 #endif
+
+#if defined __link && !defined __win32
+	if( isatty(fileno(stdout)) == 0 ){
+		//output is piped or redirected -- nobody is waiting for each line
+		m_flush_mode = flush_mode_full;
+	}
+#endif
+}
+
+int PrinterStandardOutputSink::write(const char * data, u32 size){
+	return fwrite(data, 1, size, stdout);
+}
+
+int PrinterStandardOutputSink::flush(){
+	return fflush(stdout);
+}
+
+PrinterStandardOutputSink & PrinterStandardOutputSink::instance(){
+	static PrinterStandardOutputSink sink;
+	return sink;
+}
+
+Printer & Printer::set_sink(PrinterSink * sink){
+	flush();
+	m_sink = sink;
+	return *this;
+}
+
+PrinterSink * Printer::sink() const {
+	if( m_sink == nullptr ){
+		return &PrinterStandardOutputSink::instance();
+	}
+	return m_sink;
+}
+
+void Printer::write_buffer(){
+	if( m_buffer.length() ){
+		sink()->write(m_buffer.cstring(), m_buffer.length());
+		m_buffer.clear();
+	}
+}
+
+Printer & Printer::flush(){
+	write_buffer();
+	sink()->flush();
+	return *this;
+}
+
+Printer & Printer::write(const char * data, u32 size){
+	PrinterSink * output = sink();
+	if( output->is_buffered() ){
+		//a second buffer would reorder the output relative to the sink's own
+		output->write(data, size);
+	} else {
+		if( m_buffer.length() + size > m_buffer_size ){
+			write_buffer();
+		}
+
+		if( size > m_buffer_size ){
+			//too big to buffer
+			output->write(data, size);
+		} else {
+			if( m_buffer.string().capacity() < m_buffer_size ){
+				m_buffer.string().reserve(m_buffer_size);
+			}
+			m_buffer.string().append(data, size);
+		}
+	}
+
+	if( (m_flush_mode == flush_mode_line) &&
+			(memchr(data, '\n', size) != nullptr) ){
+		flush();
+	}
+	return *this;
 }
 
 
@@ -97,6 +177,8 @@ void Printer::set_color_code(u32 code){
 		case color_code_light_yellow: color = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY; break;
 		case color_code_light_blue: color = FOREGROUND_BLUE | FOREGROUND_INTENSITY; break;
 	}
+	//the console color changes right away so the text before it must be written first
+	flush();
 	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
 #endif
 
@@ -161,10 +243,19 @@ void Printer::print(
 
 void Printer::print_final(const char * fmt, ...){
 	va_list list;
+	va_list list_copy;
+	char buffer[128];
 	va_start(list, fmt);
-	vprintf(fmt, list);
+	va_copy(list_copy, list);
+	const int length = vsnprintf(buffer, sizeof(buffer), fmt, list);
+	if( length >= static_cast<int>(sizeof(buffer)) ){
+		const var::String formatted = var::String().vformat(fmt, list_copy);
+		write(formatted.cstring(), formatted.length());
+	} else if( length > 0 ){
+		write(buffer, length);
+	}
+	va_end(list_copy);
 	va_end(list);
-	fflush(stdout);
 }
 
 Printer & Printer::open_object(
@@ -250,7 +341,9 @@ u32 Printer::color_code(const var::String & color){
 }
 
 
-Printer::~Printer(){}
+Printer::~Printer(){
+	flush();
+}
 
 #if 0
 void Printer::vprint(const char * fmt, va_list list){
@@ -394,7 +487,7 @@ bool Printer::update_progress(int progress, int total){
 				}
 			}
 			m_progress_state++;
-			fflush(stdout);
+			flush();
 		}
 
 		if( m_progress_state	> 0 ){
@@ -428,7 +521,7 @@ bool Printer::update_progress(int progress, int total){
 						 ){
 					print_final("#");
 					m_progress_state++;
-					fflush(stdout);
+					flush();
 				}
 
 				if( (progress >= total) || (total == 0) ){
@@ -444,6 +537,9 @@ bool Printer::update_progress(int progress, int total){
 				print_final("\"");
 			}
 		}
+
+		//progress is shown as it happens (even in flush_mode_full)
+		flush();
 	}
 
 	return false;
@@ -504,6 +600,8 @@ Printer & Printer::warning(const char * fmt, ...){
 	print(level_warning, "warning", var::String().vformat(fmt, list).cstring());
 	va_end(list);
 	if( flags() & print_yellow_warnings ){ clear_color_code(); }
+	//the application may exit right after a warning
+	flush();
 	return *this;
 }
 
@@ -512,6 +610,8 @@ Printer & Printer::error(const char * fmt, ...){
 	va_start(list, fmt);
 	print(level_error, "error", var::String().vformat(fmt, list).cstring());
 	va_end(list);
+	//the application may exit right after an error
+	flush();
 	return *this;
 }
 
@@ -531,6 +631,8 @@ Printer & Printer::fatal(const char * fmt, ...){
 	va_start(list, fmt);
 	print(level_fatal, "fatal", var::String().vformat(fmt, list).cstring());
 	va_end(list);
+	//the application may exit right after a fatal error
+	flush();
 	return *this;
 }
 
@@ -0,0 +1,146 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstring>
+#include "var/CharacterSet.hpp"
+
+#if defined __link && defined __GNUC__ && defined __SSE2__
+#define SAPI_CHARACTERSET_SSE2 1
+#include <emmintrin.h>
+#if defined __AVX2__
+#define SAPI_CHARACTERSET_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+using namespace var;
+
+CharacterSet & CharacterSet::clear(){
+	memset(m_table, 0, sizeof(m_table));
+	m_count = 0;
+	return *this;
+}
+
+CharacterSet & CharacterSet::add(char c){
+	if( contains(c) ){ return *this; }
+	const u8 value = static_cast<u8>(c);
+	m_table[value >> 5] |= (1UL << (value & 0x1f));
+	if( m_count < maximum_vector_count ){
+		m_list[m_count] = c;
+	}
+	m_count++;
+	return *this;
+}
+
+CharacterSet & CharacterSet::add(const CharacterSet & a){
+	if( a.count() <= maximum_vector_count ){
+		for(u32 i=0; i < a.count(); i++){
+			add(a.m_list[i]);
+		}
+		return *this;
+	}
+
+	for(u32 i=0; i < 256; i++){
+		if( a.contains(static_cast<char>(i)) ){
+			add(static_cast<char>(i));
+		}
+	}
+	return *this;
+}
+
+size_t CharacterSet::find_portable(
+		const char * data,
+		size_t length,
+		size_t position
+		) const {
+	for(; position < length; position++){
+		if( contains(data[position]) ){
+			return position;
+		}
+	}
+	return npos;
+}
+
+size_t CharacterSet::find(
+		const StringView & input,
+		size_t position
+		) const {
+	const char * data = input.data();
+	const size_t length = input.length();
+
+	if( (position >= length) || (m_count == 0) ){
+		return npos;
+	}
+
+	if( m_count == 1 ){
+		//the C library already has an optimized single character search
+		return input.find(m_list[0], position);
+	}
+
+#if defined SAPI_CHARACTERSET_SSE2
+	if( m_count <= maximum_vector_count ){
+#if defined SAPI_CHARACTERSET_AVX2
+		__m256i wide_needles[maximum_vector_count];
+		for(u32 i=0; i < m_count; i++){
+			wide_needles[i] = _mm256_set1_epi8(m_list[i]);
+		}
+
+		while( position + 32 <= length ){
+			const __m256i block = _mm256_loadu_si256(
+						reinterpret_cast<const __m256i*>(data + position)
+						);
+			__m256i matches = _mm256_cmpeq_epi8(block, wide_needles[0]);
+			for(u32 i=1; i < m_count; i++){
+				matches = _mm256_or_si256(
+							matches,
+							_mm256_cmpeq_epi8(block, wide_needles[i])
+							);
+			}
+			const u32 mask = static_cast<u32>(_mm256_movemask_epi8(matches));
+			if( mask ){
+				return position + __builtin_ctz(mask);
+			}
+			position += 32;
+		}
+#endif
+
+		__m128i needles[maximum_vector_count];
+		for(u32 i=0; i < m_count; i++){
+			needles[i] = _mm_set1_epi8(m_list[i]);
+		}
+
+		while( position + 16 <= length ){
+			const __m128i block = _mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(data + position)
+						);
+			__m128i matches = _mm_cmpeq_epi8(block, needles[0]);
+			for(u32 i=1; i < m_count; i++){
+				matches = _mm_or_si128(
+							matches,
+							_mm_cmpeq_epi8(block, needles[i])
+							);
+			}
+			const u32 mask = static_cast<u32>(_mm_movemask_epi8(matches));
+			if( mask ){
+				return position + __builtin_ctz(mask);
+			}
+			position += 16;
+		}
+	}
+#endif
+
+	return find_portable(data, length, position);
+}
+
+size_t CharacterSet::find_not(
+		const StringView & input,
+		size_t position
+		) const {
+	const char * data = input.data();
+	const size_t length = input.length();
+	for(; position < length; position++){
+		if( !contains(data[position]) ){
+			return position;
+		}
+	}
+	return npos;
+}
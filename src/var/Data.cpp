@@ -146,13 +146,12 @@ Data& Data::copy_contents(
 
 
 Data & Data::append(const Reference & reference){
-	m_data.reserve(
-				size() + reference.size()
+	//insert() grows the capacity geometrically when appending repeatedly
+	m_data.insert(
+				m_data.end(),
+				reference.to_const_u8(),
+				reference.to_const_u8() + reference.size()
 				);
-
-	for(u32 i=0; i < reference.size(); i++){
-		m_data.push_back(reference.to_const_u8()[i]);
-	}
 	update_reference();
 
 	return *this;
@@ -587,9 +587,21 @@ JsonFalse::JsonFalse(){
 	m_value = create();
 }
 
+JsonDocument::~JsonDocument(){
+	delete m_arena;
+}
+
+JsonDocument & JsonDocument::enable_arena(u32 block_size){
+	if( m_arena == nullptr ){
+		m_arena = new JsonArena(block_size);
+	}
+	return *this;
+}
+
 JsonValue JsonDocument::load(
 		FilePath path
 		){
+	JsonArena::Scope arena_scope(m_arena);
 	JsonValue value;
 	value.m_value = JsonValue::api()->load_file(
 				path.argument().cstring(),
@@ -600,34 +612,197 @@ JsonValue JsonDocument::load(
 }
 
 #if defined __link
-JsonValue JsonDocument::load(
-		XmlString xml
+#if !defined __android
+namespace {
+
+//takes ownership of value
+void xml_object_set(json_t * object, const char * key, json_t * value){
+	if( value == nullptr ){ return; }
+	JsonValue::api()->object_set(object, key, value);
+	JsonValue::api()->decref(value);
+}
+
+void xml_add_attributes(
+		rapidxml::xml_node<> * node,
+		json_t * object,
+		var::String & key
 		){
+	for(rapidxml::xml_attribute<> * attribute = node->first_attribute();
+			attribute;
+			attribute = attribute->next_attribute()){
+		key = xml2json_attribute_name_prefix;
+		key.string().append(attribute->name(), attribute->name_size());
+		xml_object_set(
+					object,
+					key.cstring(),
+					JsonValue::api()->create_string(attribute->value())
+					);
+	}
+}
+
+//builds the same values as xml2json_traverse_node() without the JSON text
+json_t * xml_create_value(
+		rapidxml::xml_node<> * node,
+		var::String & key
+		){
+	const rapidxml::node_type type = node->type();
+	if( (type == rapidxml::node_data) || (type == rapidxml::node_cdata) ){
+		return JsonValue::api()->create_string(node->value());
+	}
+
+	if( type != rapidxml::node_element ){
+		return nullptr;
+	}
+
+	rapidxml::xml_node<> * first_child = node->first_node();
+	const bool is_text_only =
+			(first_child != nullptr) &&
+			(first_child->type() == rapidxml::node_data) &&
+			(first_child->next_sibling() == nullptr);
+
+	if( node->first_attribute() == nullptr ){
+		if( first_child == nullptr ){
+			// <e />
+			return JsonValue::api()->create_null();
+		}
+
+		if( is_text_only ){
+			// <e>text</e>
+			return JsonValue::api()->create_string(first_child->value());
+		}
+	}
+
+	json_t * result = JsonValue::api()->create_object();
+	if( is_text_only ){
+		// <e attr="xxx">text</e>
+		xml_object_set(
+					result,
+					xml2json_text_additional_name,
+					JsonValue::api()->create_string(first_child->value())
+					);
+		xml_add_attributes(node, result, key);
+		return result;
+	}
+
+	xml_add_attributes(node, result, key);
+	for(rapidxml::xml_node<> * child = first_child;
+			child;
+			child = child->next_sibling()){
+
+		const char * name;
+		if( (child->type() == rapidxml::node_data) ||
+				(child->type() == rapidxml::node_cdata) ){
+			name = xml2json_text_additional_name;
+		} else if( child->type() == rapidxml::node_element ){
+			name = child->name();
+		} else {
+			continue;
+		}
+
+		json_t * value = xml_create_value(child, key);
+		if( value == nullptr ){ continue; }
+
+		//repeated names are collected in an array
+		json_t * existing = JsonValue::api()->object_get(result, name);
+		if( existing == nullptr ){
+			xml_object_set(result, name, value);
+		} else if( json_typeof(existing) == JSON_ARRAY ){
+			JsonValue::api()->array_append(existing, value);
+			JsonValue::api()->decref(value);
+		} else {
+			json_t * array = JsonValue::api()->create_array();
+			JsonValue::api()->array_append(array, existing);
+			JsonValue::api()->array_append(array, value);
+			JsonValue::api()->decref(value);
+			xml_object_set(result, name, array);
+		}
+	}
+	return result;
+}
+
+}
+#endif
+
+JsonValue JsonDocument::load_xml(char * xml){
+	JsonArena::Scope arena_scope(m_arena);
+	JsonValue result;
 #if !defined __android
-	std::string json_string
-			= xml2json(
-				xml.argument().cstring()
-				);
-	return load(String(json_string.c_str()));
+	rapidxml::xml_document<> * xml_document = new rapidxml::xml_document<>();
+	try {
+		//parse in place so names and values point in to xml
+		xml_document->parse<0>(xml);
+	} catch( const rapidxml::parse_error & error ){
+		memset(&m_error.m_value, 0, sizeof(m_error.m_value));
+		strncpy(m_error.m_value.text, error.what(), sizeof(m_error.m_value.text)-1);
+		strncpy(m_error.m_value.source, "<xml>", sizeof(m_error.m_value.source)-1);
+		m_error.m_value.position = error.where<char>() - xml;
+		delete xml_document;
+		return result;
+	}
+
+	String key;
+	result.m_value = JsonValue::api()->create_object();
+	for(rapidxml::xml_node<> * node = xml_document->first_node();
+			node;
+			node = node->next_sibling()){
+		xml_object_set(
+					result.m_value,
+					node->name(),
+					xml_create_value(node, key)
+					);
+	}
+	delete xml_document;
 #else
-	return JsonValue();
+	MCU_UNUSED_ARGUMENT(xml);
 #endif
+	return result;
 }
 
 JsonValue JsonDocument::load(
-		XmlFilePath path
+		XmlString xml
 		){
-	fs::DataFile data_file(
-				fs::File::Path(path.argument())
+	//the parser modifies the input so it needs a copy
+	Data xml_buffer(xml.argument().length() + 1);
+	memcpy(
+				xml_buffer.to_char(),
+				xml.argument().cstring(),
+				xml.argument().length() + 1
 				);
-	String xml_string = String( data_file.data() );
-	return load(XmlString(xml_string));
+	return load_xml(xml_buffer.to_char());
+}
+
+JsonValue JsonDocument::load(
+		XmlFilePath path
+		){
+	fs::File xml_file;
+	if( xml_file.open(
+				path.argument(),
+				fs::OpenFlags::read_only()
+				) < 0 ){
+		return JsonValue();
+	}
+
+	//read the file straight in to the buffer that is parsed
+	const u32 size = xml_file.size();
+	Data xml_buffer(size + 1);
+	u32 bytes_read = 0;
+	int result;
+	while( (bytes_read < size) &&
+				 ((result = xml_file.read(
+						 xml_buffer.to_char() + bytes_read,
+						 fs::File::Size(size - bytes_read))) > 0) ){
+		bytes_read += result;
+	}
+	xml_file.close();
+	xml_buffer.to_char()[bytes_read] = 0;
+	return load_xml(xml_buffer.to_char());
 }
 #endif
 
 JsonValue JsonDocument::load(
 		const var::String & json
 		){
+	JsonArena::Scope arena_scope(m_arena);
 	if( json.length() > 0 ){
 		char start_char = json.at(0);
 		if( start_char == '"' ){
@@ -694,6 +869,7 @@ size_t JsonDocument::load_file_data(
 JsonValue JsonDocument::load(
 		fs::File& file
 		){
+	JsonArena::Scope arena_scope(m_arena);
 	JsonValue value;
 	value.m_value = JsonValue::api()->load_callback(
 				load_file_data,
@@ -708,6 +884,7 @@ JsonValue JsonDocument::load(
 		json_load_callback_t callback,
 		void * context
 		){
+	JsonArena::Scope arena_scope(m_arena);
 	JsonValue value;
 	value.m_value = JsonValue::api()->load_callback(callback, context, flags(), &m_error.m_value);
 	return value;
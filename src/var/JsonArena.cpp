@@ -0,0 +1,263 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include "var/Json.hpp"
+#include "var/JsonArena.hpp"
+#include "sys/Mutex.hpp"
+#include "sys/Sched.hpp"
+
+using namespace var;
+
+namespace {
+
+//allocations are aligned for any type jansson stores
+const size_t arena_alignment = alignof(std::max_align_t);
+
+size_t align(size_t size){
+	return (size + arena_alignment - 1) & ~(arena_alignment - 1);
+}
+
+//number of live arenas (the first installs the allocation functions)
+u32 arena_count = 0;
+
+//the blocks of every live arena sorted by address
+class ArenaRange {
+public:
+	const u8 * start;
+	const u8 * end;
+	bool operator < (const ArenaRange & a) const { return start < a.start; }
+};
+
+//the master list is only used with the mutex locked
+var::Vector<ArenaRange> & range_list(){
+	static var::Vector<ArenaRange> list;
+	return list;
+}
+
+//a copy of the list is published for is_arena_memory() so that
+//freeing memory never takes the mutex -- a published copy is never
+//modified and is only deleted once no reader can be using it
+std::atomic<const var::Vector<ArenaRange>*> published_range_list(nullptr);
+std::atomic<u32> range_reader_count(0);
+
+//called with the mutex locked after the list changes
+void publish_range_list(){
+	const var::Vector<ArenaRange> & list = range_list();
+	const var::Vector<ArenaRange> * next = list.count() ?
+				new var::Vector<ArenaRange>(list) : nullptr;
+	const var::Vector<ArenaRange> * previous =
+			published_range_list.exchange(next);
+	if( previous != nullptr ){
+		//readers that loaded previous finish a binary search then leave
+		while( range_reader_count.load() != 0 ){
+			sys::Sched::yield();
+		}
+		delete previous;
+	}
+}
+
+void add_range(const var::Data * block){
+	ArenaRange range;
+	range.start = block->to_const_u8();
+	range.end = range.start + block->size();
+	var::Vector<ArenaRange> & list = range_list();
+	list.insert(std::upper_bound(list.begin(), list.end(), range), range);
+	publish_range_list();
+}
+
+void remove_range(const var::Data * block){
+	ArenaRange range;
+	range.start = block->to_const_u8();
+	var::Vector<ArenaRange> & list = range_list();
+	auto iterator = std::lower_bound(list.begin(), list.end(), range);
+	if( (iterator != list.end()) && (iterator->start == range.start) ){
+		list.remove(iterator - list.begin());
+	}
+	publish_range_list();
+}
+
+sys::Mutex & arena_mutex(){
+	static sys::Mutex mutex;
+	return mutex;
+}
+
+#if defined __link
+thread_local JsonArena * active_arena = nullptr;
+
+json_malloc_t previous_malloc = nullptr;
+json_free_t previous_free = nullptr;
+
+void * arena_malloc(size_t size){
+	JsonArena * arena = active_arena;
+	if( arena != nullptr ){
+		return arena->allocate(size);
+	}
+	return previous_malloc(size);
+}
+
+void arena_free(void * pointer){
+	if( pointer == nullptr ){ return; }
+	//arena memory is released with the arena
+	JsonArena * arena = active_arena;
+	if( (arena != nullptr) && arena->is_in_arena(pointer) ){
+		return;
+	}
+	if( JsonArena::is_arena_memory(pointer) == false ){
+		previous_free(pointer);
+	}
+}
+#else
+JsonArena * active_arena = nullptr;
+#endif
+
+}
+
+JsonArena::Scope::Scope(JsonArena * arena){
+	m_previous = active_arena;
+	if( arena != nullptr ){
+		active_arena = arena;
+	}
+}
+
+JsonArena::Scope::~Scope(){
+	active_arena = m_previous;
+}
+
+JsonArena * JsonArena::active(){
+	return active_arena;
+}
+
+JsonArena::JsonArena(u32 block_size){
+	m_block_size = block_size;
+
+	arena_mutex().lock();
+#if defined __link
+	if( arena_count == 0 ){
+		//the first arena installs the allocation functions
+		json_get_alloc_funcs(&previous_malloc, &previous_free);
+		json_set_alloc_funcs(arena_malloc, arena_free);
+	}
+#endif
+	arena_count++;
+	arena_mutex().unlock();
+}
+
+JsonArena::~JsonArena(){
+	arena_mutex().lock();
+	for(var::Data * block: m_block_list){
+		remove_range(block);
+	}
+	arena_count--;
+#if defined __link
+	if( arena_count == 0 ){
+		//the last arena restores the allocation functions
+		json_set_alloc_funcs(previous_malloc, previous_free);
+	}
+#endif
+	arena_mutex().unlock();
+
+	for(var::Data * block: m_block_list){
+		delete block;
+	}
+}
+
+var::Data * JsonArena::add_block(size_t size){
+	var::Data * block = new var::Data(size);
+	if( block->size() < size ){
+		delete block;
+		return nullptr;
+	}
+
+	arena_mutex().lock();
+	m_block_list.push_back(block);
+	add_range(block);
+	arena_mutex().unlock();
+
+	m_capacity += size;
+	return block;
+}
+
+void * JsonArena::allocate(size_t size){
+	const size_t aligned_size = align(size > 0 ? size : 1);
+	var::Data * block = m_block_index < m_block_list.count() ?
+				m_block_list.at(m_block_index) : nullptr;
+
+	while( (block != nullptr) &&
+				 (m_block_offset + aligned_size > block->size()) ){
+		//move to the next block that was kept by reset()
+		m_block_index++;
+		m_block_offset = 0;
+		block = m_block_index < m_block_list.count() ?
+					m_block_list.at(m_block_index) : nullptr;
+	}
+
+	if( block == nullptr ){
+		//blocks grow (up to 16 times block_size()) as the arena fills
+		size_t next_size = m_block_size;
+		if( m_capacity > next_size ){
+			next_size = m_capacity < 16UL*m_block_size ? m_capacity : 16UL*m_block_size;
+		}
+
+		//large values get a block of their own
+		block = add_block(
+					aligned_size > next_size ? aligned_size : next_size
+					);
+		if( block == nullptr ){
+			set_error_number(api::error_code_var_json_out_of_memory);
+			return nullptr;
+		}
+		m_block_index = m_block_list.count() - 1;
+		m_block_offset = 0;
+	}
+
+	void * result = block->to_u8() + m_block_offset;
+	m_block_offset += aligned_size;
+	m_size += aligned_size;
+	m_allocation_count++;
+	return result;
+}
+
+bool JsonArena::is_arena_memory(const void * pointer){
+	ArenaRange range;
+	range.start = static_cast<const u8*>(pointer);
+	bool result = false;
+
+	range_reader_count++;
+	const var::Vector<ArenaRange> * list = published_range_list.load();
+	if( list != nullptr ){
+		//the last block that starts at or before pointer is the only candidate
+		auto iterator = std::upper_bound(list->begin(), list->end(), range);
+		if( iterator != list->begin() ){
+			--iterator;
+			result = range.start < iterator->end;
+		}
+	}
+	range_reader_count--;
+	return result;
+}
+
+bool JsonArena::is_in_arena(const void * pointer) const {
+	const u8 * value = static_cast<const u8*>(pointer);
+	for(const var::Data * block: m_block_list){
+		const u8 * start = block->to_const_u8();
+		if( (value >= start) && (value < start + block->size()) ){
+			return true;
+		}
+	}
+	return false;
+}
+
+void JsonArena::reset(){
+	if( m_size > m_peak_size ){
+		m_peak_size = m_size;
+	}
+
+	//the blocks are kept so the next document doesn't need the heap
+	m_block_index = 0;
+	m_block_offset = 0;
+	m_size = 0;
+	m_allocation_count = 0;
+}
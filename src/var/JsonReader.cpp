@@ -0,0 +1,455 @@
+/*! \file */ // Copyright 2011-2020 Tyler Gilbert and Stratify Labs, Inc; see LICENSE.md for rights.
+
+#include <cstdint>
+#include <cstdio>
+#include "var/JsonReader.hpp"
+
+#include "rapidjson/reader.h"
+#include "rapidjson/error/en.h"
+
+namespace var {
+
+/*! \cond */
+
+//rapidjson input stream that reads from a fs::File one block at a time
+class JsonReaderStream {
+public:
+	typedef char Ch;
+
+	JsonReaderStream(const fs::File & file, u32 buffer_size)
+		: m_file(file), m_buffer(buffer_size){
+		m_current = m_buffer.to_char();
+		m_end = m_current;
+	}
+
+	//the file is only read when another character is needed so a
+	//socket isn't read again after the last character of the root value
+	Ch Peek(){
+		if( m_current == m_end ){
+			read_block();
+			if( m_current == m_end ){
+				//a null character tells rapidjson the input is finished
+				return '\0';
+			}
+		}
+		return *m_current;
+	}
+
+	Ch Take(){
+		Ch c = Peek();
+		if( m_current < m_end ){
+			m_current++;
+		}
+		return c;
+	}
+
+	size_t Tell() const {
+		return m_offset + (m_current - m_buffer.to_char());
+	}
+
+	//the reader never writes to the stream
+	Ch * PutBegin(){ RAPIDJSON_ASSERT(false); return nullptr; }
+	void Put(Ch){ RAPIDJSON_ASSERT(false); }
+	void Flush(){ RAPIDJSON_ASSERT(false); }
+	size_t PutEnd(Ch*){ RAPIDJSON_ASSERT(false); return 0; }
+
+	u32 bytes_read() const { return m_bytes_read; }
+	bool is_read_error() const { return m_is_read_error; }
+
+private:
+	const fs::File & m_file;
+	var::Data m_buffer;
+	char * m_current;
+	char * m_end;
+	size_t m_offset = 0;
+	u32 m_bytes_read = 0;
+	bool m_is_eof = false;
+	bool m_is_read_error = false;
+
+	void read_block(){
+		if( m_is_eof ){ return; }
+		char * buffer = m_buffer.to_char();
+		m_offset = m_bytes_read;
+		m_current = buffer;
+		m_end = buffer;
+
+		//a short read (socket or link) is not the end of the file
+		int result = m_file.read(
+					buffer,
+					fs::File::Size(m_buffer.size())
+					);
+
+		if( result > 0 ){
+			m_bytes_read += result;
+			m_end = buffer + result;
+		} else {
+			m_is_read_error = (result < 0);
+			m_is_eof = true;
+		}
+	}
+};
+
+//tracks the JSON pointer of each value and either reports
+//events or builds the values that match the path list
+class JsonReaderHandler {
+public:
+
+	JsonReaderHandler(
+			JsonReader::EventCallback event_callback,
+			const StringList * path_list,
+			JsonReader::ValueCallback value_callback
+			) : m_event_callback(event_callback),
+		m_path_list(path_list),
+		m_value_callback(value_callback){
+		m_event.m_path = &m_path;
+	}
+
+	bool Null(){ return scalar(JsonReader::event_null); }
+	bool Bool(bool value){
+		return scalar(value ? JsonReader::event_true : JsonReader::event_false);
+	}
+
+	bool Int(int value){ return integer(value); }
+	bool Uint(unsigned value){ return integer(value); }
+	bool Int64(int64_t value){ return integer(value); }
+	bool Uint64(uint64_t value){
+		if( value > static_cast<uint64_t>(INT64_MAX) ){
+			return Double(static_cast<double>(value));
+		}
+		return integer(static_cast<s64>(value));
+	}
+
+	bool Double(double value){
+		m_event.m_real = value;
+		return scalar(JsonReader::event_real);
+	}
+
+	bool RawNumber(const char * value, rapidjson::SizeType length, bool copy){
+		MCU_UNUSED_ARGUMENT(copy);
+		return String(value, length, true);
+	}
+
+	bool String(const char * value, rapidjson::SizeType length, bool copy){
+		MCU_UNUSED_ARGUMENT(copy);
+		m_event.m_string = StringView(value, length);
+		const bool result = scalar(JsonReader::event_string);
+		m_event.m_string = StringView();
+		return result;
+	}
+
+	bool Key(const char * value, rapidjson::SizeType length, bool copy){
+		MCU_UNUSED_ARGUMENT(copy);
+		m_key.string().assign(value, length);
+		return true;
+	}
+
+	bool StartObject(){ return start(JsonReader::event_start_object); }
+	bool EndObject(rapidjson::SizeType count){
+		MCU_UNUSED_ARGUMENT(count);
+		return end(JsonReader::event_end_object);
+	}
+
+	bool StartArray(){ return start(JsonReader::event_start_array); }
+	bool EndArray(rapidjson::SizeType count){
+		MCU_UNUSED_ARGUMENT(count);
+		return end(JsonReader::event_end_array);
+	}
+
+private:
+
+	class Level {
+	public:
+		size_t path_length; //length of the container's own path
+		u32 index;
+		bool is_array;
+	};
+
+	JsonReader::EventCallback m_event_callback;
+	const StringList * m_path_list;
+	JsonReader::ValueCallback m_value_callback;
+
+	JsonReader::Event m_event;
+	var::String m_path;
+	var::String m_key;
+	var::Vector<Level> m_level_list;
+
+	//containers of the value that is being built
+	var::Vector<JsonValue> m_capture_list;
+	bool m_is_capture = false;
+
+	bool integer(s64 value){
+		m_event.m_integer = value;
+		return scalar(JsonReader::event_integer);
+	}
+
+	//updates the path and event for the next value
+	void begin_value(enum JsonReader::event_type type){
+		m_event.m_type = type;
+		m_event.m_depth = m_level_list.count();
+		m_event.m_key = StringView();
+		m_event.m_index = 0;
+
+		if( m_level_list.count() == 0 ){
+			m_path.clear();
+			return;
+		}
+
+		Level & parent = m_level_list.back();
+		m_path.string().resize(parent.path_length);
+		m_path.push_back('/');
+		if( parent.is_array ){
+			m_event.m_index = parent.index++;
+			char index[12];
+			int length = snprintf(index, sizeof(index), "%lu", static_cast<unsigned long>(m_event.m_index));
+			m_path.string().append(index, length);
+		} else {
+			m_event.m_key = StringView(m_key);
+			for(char c: m_key){
+				//escape the key as specified by RFC 6901
+				if( c == '~' ){
+					m_path.string().append("~0");
+				} else if( c == '/' ){
+					m_path.string().append("~1");
+				} else {
+					m_path.push_back(c);
+				}
+			}
+		}
+	}
+
+	bool is_path_listed() const {
+		for(const var::String & path: *m_path_list){
+			if( JsonReader::is_path_match(path, m_path) ){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	JsonValue create_value() const {
+		JsonValue result;
+		switch(m_event.m_type){
+			case JsonReader::event_start_object:
+				result.m_value = JsonValue::api()->create_object();
+				break;
+			case JsonReader::event_start_array:
+				result.m_value = JsonValue::api()->create_array();
+				break;
+			case JsonReader::event_string:
+				result.m_value = JsonValue::api()->create_string(
+							m_event.m_string.to_string().cstring()
+							);
+				break;
+			case JsonReader::event_integer:
+				result.m_value = JsonValue::api()->create_integer(m_event.m_integer);
+				break;
+			case JsonReader::event_real:
+				result.m_value = JsonValue::api()->create_real(m_event.m_real);
+				break;
+			case JsonReader::event_true:
+				result.m_value = JsonValue::api()->create_true();
+				break;
+			case JsonReader::event_false:
+				result.m_value = JsonValue::api()->create_false();
+				break;
+			default:
+				result.m_value = JsonValue::api()->create_null();
+				break;
+		}
+		return result;
+	}
+
+	//returns false if the value callback stops the reader
+	bool capture(const JsonValue & value){
+		if( m_capture_list.count() == 0 ){
+			//the value is complete
+			m_is_capture = false;
+			return m_value_callback(m_path, value);
+		}
+
+		JsonValue & parent = m_capture_list.back();
+		if( parent.is_array() ){
+			parent.to_array().append(value);
+		} else {
+			parent.to_object().insert(m_key, value);
+		}
+		return true;
+	}
+
+	bool dispatch(){
+		if( m_event_callback ){
+			return m_event_callback(m_event);
+		}
+		return true;
+	}
+
+	bool scalar(enum JsonReader::event_type type){
+		begin_value(type);
+		if( m_path_list == nullptr ){
+			return dispatch();
+		}
+
+		if( m_is_capture || is_path_listed() ){
+			m_is_capture = true;
+			return capture(create_value());
+		}
+		return true;
+	}
+
+	bool start(enum JsonReader::event_type type){
+		begin_value(type);
+		Level level;
+		level.path_length = m_path.length();
+		level.index = 0;
+		level.is_array = (type == JsonReader::event_start_array);
+		m_level_list.push_back(level);
+
+		if( m_path_list == nullptr ){
+			return dispatch();
+		}
+
+		if( m_is_capture || is_path_listed() ){
+			m_is_capture = true;
+			JsonValue value = create_value();
+			if( m_capture_list.count() > 0 ){
+				//add to the parent now and fill in as the members arrive
+				capture(value);
+			}
+			m_capture_list.push_back(value);
+		}
+		return true;
+	}
+
+	bool end(enum JsonReader::event_type type){
+		const Level level = m_level_list.back();
+		m_level_list.pop_back();
+		m_path.string().resize(level.path_length);
+
+		m_event.m_type = type;
+		m_event.m_depth = m_level_list.count();
+		m_event.m_key = StringView();
+		m_event.m_index = 0;
+
+		if( m_path_list == nullptr ){
+			return dispatch();
+		}
+
+		if( m_is_capture ){
+			JsonValue value = m_capture_list.back();
+			m_capture_list.pop_back();
+			if( m_capture_list.count() == 0 ){
+				return capture(value);
+			}
+		}
+		return true;
+	}
+};
+
+/*! \endcond */
+
+}
+
+using namespace var;
+
+namespace {
+
+template<unsigned flags> rapidjson::ParseResult parse(
+		JsonReaderStream & stream,
+		JsonReaderHandler & handler
+		){
+	//iterative parsing keeps deeply nested input off the call stack
+	rapidjson::Reader reader;
+	return reader.Parse<
+			flags |
+			rapidjson::kParseIterativeFlag |
+			rapidjson::kParseStopWhenDoneFlag>(stream, handler);
+}
+
+}
+
+int JsonReader::read(EventCallback callback){
+	JsonReaderHandler handler(callback, nullptr, ValueCallback());
+	return read_with_handler(handler);
+}
+
+int JsonReader::read(
+		const StringList & path_list,
+		ValueCallback callback
+		){
+	JsonReaderHandler handler(EventCallback(), &path_list, callback);
+	return read_with_handler(handler);
+}
+
+int JsonReader::read_with_handler(JsonReaderHandler & handler){
+	JsonReaderStream stream(m_file, m_options.buffer_size());
+	rapidjson::ParseResult result;
+
+	if( m_options.is_allow_comments() && m_options.is_allow_trailing_commas() ){
+		result = parse<rapidjson::kParseCommentsFlag|rapidjson::kParseTrailingCommasFlag>(stream, handler);
+	} else if( m_options.is_allow_comments() ){
+		result = parse<rapidjson::kParseCommentsFlag>(stream, handler);
+	} else if( m_options.is_allow_trailing_commas() ){
+		result = parse<rapidjson::kParseTrailingCommasFlag>(stream, handler);
+	} else {
+		result = parse<rapidjson::kParseNoFlags>(stream, handler);
+	}
+
+	m_bytes_read = stream.bytes_read();
+	m_error_offset = 0;
+	m_error_message.clear();
+
+	if( result.IsError() == false ||
+			result.Code() == rapidjson::kParseErrorTermination ){
+		//the callback stopped the reader
+		return 0;
+	}
+
+	m_error_offset = result.Offset();
+	if( stream.is_read_error() ){
+		m_error_message = "failed to read file";
+		return set_error_number_if_error(api::error_code_fs_failed_to_read);
+	}
+
+	m_error_message = rapidjson::GetParseError_En(result.Code());
+	if( result.Code() == rapidjson::kParseErrorDocumentEmpty ){
+		return set_error_number_if_error(api::error_code_var_json_premature_end_of_input);
+	}
+	return set_error_number_if_error(api::error_code_var_json_invalid_syntax);
+}
+
+bool JsonReader::is_path_match(
+		const StringView & pattern,
+		const StringView & path
+		){
+	size_t pattern_position = 0;
+	size_t path_position = 0;
+
+	while( (pattern_position < pattern.length()) &&
+				 (path_position < path.length()) ){
+
+		if( (pattern.at(pattern_position) != '/') ||
+				(path.at(path_position) != '/') ){
+			return false;
+		}
+		pattern_position++;
+		path_position++;
+
+		size_t pattern_end = pattern.find('/', pattern_position);
+		if( pattern_end == StringView::npos ){ pattern_end = pattern.length(); }
+		size_t path_end = path.find('/', path_position);
+		if( path_end == StringView::npos ){ path_end = path.length(); }
+
+		const StringView pattern_segment =
+				pattern.sub_view(pattern_position, pattern_end - pattern_position);
+		if( (pattern_segment != "*") &&
+				(pattern_segment != path.sub_view(path_position, path_end - path_position)) ){
+			return false;
+		}
+
+		pattern_position = pattern_end;
+		path_position = path_end;
+	}
+
+	return (pattern_position == pattern.length()) &&
+			(path_position == path.length());
+}
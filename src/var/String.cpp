@@ -4,12 +4,14 @@
 
 #include <errno.h>
 #include <cctype>
+#include <cmath>
 #include <cstdio>
 #include <cstdarg>
 #include <cstring>
 #include "var/Data.hpp"
 #include "var/String.hpp"
 #include "var/Tokenizer.hpp"
+#include "var/CharacterSet.hpp"
 #include "sys.hpp"
 
 using namespace var;
@@ -58,40 +60,147 @@ String& String::vformat(
 		va_list list
 		){
 
+	if( fmt == nullptr ){ return *this; }
+	//the arguments may point in to this string (such as cstring())
+	String result;
+	result.append_vformat(fmt, list);
+	m_string.swap(result.m_string);
+	return *this;
+}
+
+String & String::append_format(const char * format, ...){
+	va_list args;
+	va_start(args, format);
+	append_vformat(format, args);
+	va_end(args);
+	return *this;
+}
+
+String & String::append_vformat(
+		const char * fmt,
+		va_list list
+		){
+
 	if( fmt == nullptr ){ return *this; }
 
 	va_list list_copy;
 	va_copy(list_copy, list);
-	const int buffer_size = 64;
-	char buffer[buffer_size];
+
+	//format in to the spare capacity (at least 64 bytes)
+	const size_t start = m_string.length();
+	size_t available = m_string.capacity() - start;
+	if( available < 64 ){
+		available = 64;
+	}
+	m_string.resize(start + available);
+
 	int size = vsnprintf(
-				buffer,
-				buffer_size-1,
+				&m_string[start],
+				available + 1,
 				fmt,
 				list
 				);
-	if( size <= buffer_size-1 ){
-		*this = String(buffer);
-	} else {
-		Data tmp(size+1);
+
+	if( size > static_cast<int>(available) ){
+		//the capacity is now known -- format again
+		m_string.resize(start + size);
 		size = vsnprintf(
-					tmp.to_char(),
-					tmp.size(),
+					&m_string[start],
+					size + 1,
 					fmt,
 					list_copy
 					);
-
-		if( size > 0 ){
-			*this = String(tmp.to_const_char());
-		} else {
-			clear();
-		}
 	}
+
+	m_string.resize(start + (size > 0 ? size : 0));
 	va_end(list_copy);
 
 	return *this;
 }
 
+String & String::append_unsigned(u64 value){
+	char buffer[20];
+	u32 position = sizeof(buffer);
+	do {
+		buffer[--position] = '0' + (value % 10);
+		value /= 10;
+	} while( value );
+	m_string.append(buffer + position, sizeof(buffer) - position);
+	return *this;
+}
+
+String & String::append_integer(s64 value){
+	if( value < 0 ){
+		m_string.append(1, '-');
+		//negate as unsigned so the smallest value doesn't overflow
+		return append_unsigned(0 - static_cast<u64>(value));
+	}
+	return append_unsigned(value);
+}
+
+String & String::append_hex(u64 value, u32 width, bool is_upper){
+	const char * digits = is_upper ? "0123456789ABCDEF" : "0123456789abcdef";
+	char buffer[16];
+	u32 position = sizeof(buffer);
+	do {
+		buffer[--position] = digits[value & 0x0f];
+		value >>= 4;
+	} while( value );
+
+	const u32 length = sizeof(buffer) - position;
+	if( width > length ){
+		m_string.append(width - length, '0');
+	}
+	m_string.append(buffer + position, length);
+	return *this;
+}
+
+String & String::append_float(float value, u32 precision){
+	static const u32 scale_list[] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+	};
+
+	const float magnitude = value < 0.0f ? -value : value;
+	if( (magnitude != magnitude) || //NaN
+			(magnitude >= 4294967296.0f) ||
+			(precision >= sizeof(scale_list)/sizeof(scale_list[0])) ){
+		return append_format("%0.*f", static_cast<int>(precision), static_cast<double>(value));
+	}
+
+	const u32 scale = scale_list[precision];
+	u64 integer = static_cast<u64>(magnitude);
+	const double scaled = (static_cast<double>(magnitude) - integer) * scale;
+	u64 fraction = static_cast<u64>(scaled);
+	const double remainder = scaled - fraction;
+	//round half to even like printf()
+	const u64 last_digit = precision ? fraction : integer;
+	if( (remainder > 0.5) || ((remainder == 0.5) && (last_digit & 0x01)) ){
+		fraction++;
+	}
+	if( fraction >= scale ){
+		//rounding carried in to the integer part
+		integer++;
+		fraction -= scale;
+	}
+
+	if( std::signbit(value) ){
+		//printf() keeps the sign of -0.0
+		m_string.append(1, '-');
+	}
+	append_unsigned(integer);
+
+	if( precision ){
+		m_string.append(1, '.');
+		char buffer[10];
+		for(u32 i = precision; i > 0; i--){
+			buffer[i-1] = '0' + (fraction % 10);
+			fraction /= 10;
+		}
+		m_string.append(buffer, precision);
+	}
+	return *this;
+}
+
 
 
 String& String::erase(
@@ -115,16 +224,104 @@ String& String::replace(
 		Position position,
 		Length length
 		){
-	size_t pos = position.argument();
-	size_t old_length = old_string.length();
-	size_t new_length = new_string.argument().length();
+	const size_t old_length = old_string.length();
+	const size_t new_length = new_string.argument().length();
+	const size_t maximum_count = length.argument() ? length.argument() : npos;
+
+	if( old_length == 0 ){
+		return *this;
+	}
+
+	//count the matches so the output is allocated once
 	size_t replaced_count = 0;
-	while( ((pos = find(old_string, Position(pos))) != String::npos) &&
-				 (length.argument() ? replaced_count < length.argument() : 1) ){
-		erase(Position(pos), Length(old_length));
-		insert(Position(pos), new_string.argument());
-		pos += new_length;
+	size_t pos = position.argument();
+	while( (replaced_count < maximum_count) &&
+				 ((pos = m_string.find(old_string.string(), pos)) != std::string::npos) ){
 		replaced_count++;
+		pos += old_length;
+	}
+
+	if( replaced_count == 0 ){
+		return *this;
+	}
+
+	std::string result;
+	result.reserve(m_string.length() - replaced_count*old_length + replaced_count*new_length);
+
+	size_t start = 0;
+	pos = position.argument();
+	for(size_t i=0; i < replaced_count; i++){
+		pos = m_string.find(old_string.string(), pos);
+		result.append(m_string, start, pos - start);
+		result.append(new_string.argument().string());
+		pos += old_length;
+		start = pos;
+	}
+	result.append(m_string, start, npos);
+
+	m_string = std::move(result);
+	return *this;
+}
+
+String& String::replace_all(const Vector<Replacement> & replacement_list){
+
+	//the first character of each pattern marks where a match can start
+	CharacterSet first_character_set;
+	Vector<const Replacement*> pattern_list;
+	for(const Replacement & replacement: replacement_list){
+		if( replacement.from().length() > 0 ){
+			first_character_set.add(replacement.from().at(0));
+			pattern_list.push_back(&replacement);
+		}
+	}
+
+	if( pattern_list.count() == 0 ){
+		return *this;
+	}
+
+	//check the longest patterns first
+	std::stable_sort(
+				pattern_list.begin(),
+				pattern_list.end(),
+				[](const Replacement * a, const Replacement * b){
+		return a->from().length() > b->from().length();
+	});
+
+	const StringView input(*this);
+	std::string result;
+	bool is_replaced = false;
+	size_t start = 0;
+	size_t pos = 0;
+
+	while( (pos = first_character_set.find(input, pos)) != CharacterSet::npos ){
+		const Replacement * match = nullptr;
+		for(const Replacement * replacement: pattern_list){
+			const String & from = replacement->from();
+			if( (from.length() <= input.length() - pos) &&
+					(memcmp(input.data() + pos, from.cstring(), from.length()) == 0) ){
+				match = replacement;
+				break;
+			}
+		}
+
+		if( match == nullptr ){
+			pos++;
+			continue;
+		}
+
+		if( is_replaced == false ){
+			result.reserve(length());
+			is_replaced = true;
+		}
+		result.append(m_string, start, pos - start);
+		result.append(match->to().string());
+		pos += match->from().length();
+		start = pos;
+	}
+
+	if( is_replaced ){
+		result.append(m_string, start, npos);
+		m_string = std::move(result);
 	}
 	return *this;
 }
@@ -175,11 +372,11 @@ float String::to_float() const {
 
 
 Vector<String> String::split(const String & delimiter) const {
-	Tokenizer tokens(
-				*this,
-				Tokenizer::Delimeters(delimiter)
-				);
-	return tokens.list();
+	Vector<String> result;
+	for(const StringView & token: Tokenizer::parse_views(*this, delimiter)){
+		result.push_back(token.to_string());
+	}
+	return result;
 }
 
 
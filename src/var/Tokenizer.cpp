@@ -62,43 +62,102 @@ void Tokenizer::parse(
 		MaximumCount maximum_count
 		){
 
-	const u32 max_delimeter_count = maximum_count.argument();
-	const u32 length = input.length();
 	m_token_list = StringList();
-	u32 cursor = 0;
-	u32 sub_position = 0;
-
-	while( cursor < length ){
-		if( delim.argument().find( input.at(cursor) ) != String::npos ){
-			m_token_list.push_back(
-						input.create_sub_string(
-							String::Position(sub_position),
-							String::Length(cursor - sub_position)
-							)
-						);
-			sub_position = cursor + 1;
-			if( max_delimeter_count && (m_token_list.count() == max_delimeter_count) ){
-				cursor = length-1;
-			}
-		} else if( ignore.argument().find( input.at(cursor) ) != String::npos ){
-			//skip the space between specific characters
-			char end = input.at(cursor);
-			cursor++;
-			while( (cursor < length) && (input.at(cursor) != end) ){
-				cursor++;
-			}
+	for(const StringView & token:
+			parse_views(
+				input,
+				delim.argument(),
+				ignore.argument(),
+				maximum_count.argument()
+				)
+			){
+		m_token_list.push_back(token.to_string());
+	}
+}
+
+Tokenizer::ViewRange::ViewRange(
+		const StringView & input,
+		const StringView & delimeters,
+		const StringView & ignore_between,
+		u32 maximum_delimeter_count
+		) : m_input(input){
+	m_maximum_delimeter_count = maximum_delimeter_count;
+	CharacterSet delimeter_set(delimeters);
+	for(char c: ignore_between){
+		//a delimeter takes precedence over an ignore-between character
+		if( delimeter_set.contains(c) == false ){
+			m_ignore_between_set.add(c);
+		}
+	}
+	m_special_set.add(delimeter_set).add(m_ignore_between_set);
+}
+
+size_t Tokenizer::ViewRange::find_delimeter(size_t position) const {
+	const size_t length = m_input.length();
+
+	while( position < length ){
+		//jump to the next delimeter or ignore-between character
+		position = m_special_set.find(m_input, position);
+		if( position == CharacterSet::npos ){
+			return length;
+		}
+
+		const char c = m_input.at(position);
+		if( m_ignore_between_set.contains(c) == false ){
+			return position;
+		}
+
+		//skip the space between specific characters
+		position = m_input.find(c, position+1);
+		if( position == StringView::npos ){
+			return length;
 		}
+		position++;
+	}
+	return length;
+}
 
-		cursor++;
+void Tokenizer::ViewRange::load_next(Iterator & iterator) const {
+	if( iterator.m_is_last ){
+		iterator = Iterator();
+		return;
 	}
 
-	//push the last token
-	m_token_list.push_back(
-				input.create_sub_string(
-					String::Position(sub_position),
-					String::Length(cursor - sub_position)
-					)
-				);
+	const size_t length = m_input.length();
+	const size_t start = iterator.m_position;
+	size_t position = length;
+
+	if( (m_maximum_delimeter_count == 0) ||
+			(iterator.m_count < m_maximum_delimeter_count) ){
+		position = find_delimeter(start);
+	}
+
+	if( position >= length ){
+		//the last token is whatever is left
+		iterator.m_token = m_input.sub_view(start);
+		iterator.m_position = length;
+		iterator.m_is_last = true;
+	} else {
+		iterator.m_token = m_input.sub_view(start, position - start);
+		iterator.m_position = position + 1;
+		iterator.m_count++;
+	}
+}
+
+Tokenizer::ViewRange::Iterator Tokenizer::ViewRange::begin() const {
+	Iterator result;
+	result.m_range = this;
+	result.m_is_end = false;
+	load_next(result);
+	return result;
+}
+
+u32 Tokenizer::ViewRange::count() const {
+	u32 result = 0;
+	for(Iterator iterator = begin(); iterator != end(); ++iterator){
+		result++;
+	}
+	return result;
 }
 
 const String& Tokenizer::at(u32 n) const {